@@ -0,0 +1,522 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Microbenchmarks de las rutas críticas con salida JSON
+ * @details Mide por separado CircularBuffer (insert, sort, getData, clear), la lectura
+ *          de chunks con FileSource y MappedFileSource (getNext y read por lotes),
+ *          MergeSort::merge para varios K y N, y el ordenamiento y la fusión de
+ *          TelemetryRecord (clave de 64 bits). El resultado es un documento JSON para
+ *          comparar entre versiones.
+ *
+ * Uso: esort_bench [--quick] [--repeat N] [--filter TEXTO] [--tmpdir DIR] [--output ARCHIVO]
+ */
+
+#include "CircularBuffer.h"
+#include "ChunkFile.h"
+#include "FileSource.h"
+#include "MappedFileSource.h"
+#include "MergeSort.h"
+#include "MergePlanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @struct BenchmarkOptions
+ * @brief Parámetros de la ejecución
+ */
+struct BenchmarkOptions {
+    bool quick = false;     ///< Tamaños reducidos (para CI o pruebas rápidas)
+    int repeat = 5;         ///< Repeticiones por caso; se informan la mejor y la mediana
+    string filter;          ///< Solo casos cuyo nombre contenga este texto
+    string tmpdir = ".";    ///< Directorio de los archivos temporales
+    string output;          ///< Archivo JSON de salida (vacío = stdout)
+};
+
+/**
+ * @struct BenchmarkResult
+ * @brief Resultado de un caso
+ */
+struct BenchmarkResult {
+    string name;            ///< Nombre del caso (p. ej. "circular_buffer.sort")
+    string params;          ///< Parámetros como objeto JSON ya formateado
+    uint64_t items;         ///< Elementos procesados por repetición
+    uint64_t bytes;         ///< Bytes procesados por repetición (0 si no aplica)
+    vector<double> seconds; ///< Tiempo de cada repetición
+};
+
+namespace {
+
+/**
+ * @brief Cronometra una función
+ * @param fn Función a medir
+ * @return Segundos transcurridos
+ */
+double timeIt(const function<void()>& fn) {
+    auto start = chrono::steady_clock::now();
+    fn();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Genera valores aleatorios reproducibles
+ * @param count Número de valores
+ * @param seed Semilla
+ * @return Vector con los valores
+ */
+vector<int> randomValues(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    vector<int> values(count);
+    for (size_t i = 0; i < count; i++) {
+        values[i] = static_cast<int>(rng());
+    }
+    return values;
+}
+
+/**
+ * @brief Genera lecturas de telemetría reproducibles con marcas de tiempo desordenadas
+ * @param count Número de registros
+ * @param seed Semilla
+ * @return Vector con los registros
+ * @details Las marcas de tiempo caen en una ventana de una hora en microsegundos, como
+ *          lecturas reales que llegan fuera de orden desde varios sensores
+ */
+vector<TelemetryRecord> randomTelemetry(size_t count, unsigned seed) {
+    mt19937_64 rng(seed);
+    const int64_t epoch = 1700000000000000LL;
+    vector<TelemetryRecord> records(count);
+    for (size_t i = 0; i < count; i++) {
+        records[i].timestamp = epoch + static_cast<int64_t>(rng() % 3600000000ULL);
+        records[i].sensorId = static_cast<uint32_t>(rng() % 64);
+        records[i].value = static_cast<int32_t>(rng());
+    }
+    return records;
+}
+
+/**
+ * @brief Tamaño de un archivo en bytes
+ * @param filename Ruta del archivo
+ * @return Tamaño, o 0 si no se puede abrir
+ */
+uint64_t fileSize(const string& filename) {
+    ifstream file(filename, ios::binary | ios::ate);
+    return file ? static_cast<uint64_t>(file.tellg()) : 0;
+}
+
+/**
+ * @brief Escribe un número en JSON (los no finitos como 0)
+ * @param value Número
+ * @return Texto JSON
+ */
+string jsonNumber(double value) {
+    if (!(value == value) || value > 1e300 || value < -1e300) return "0";
+    ostringstream out;
+    out.precision(6);
+    out << value;
+    return out.str();
+}
+
+} // namespace
+
+/**
+ * @class BenchmarkRunner
+ * @brief Ejecuta los casos seleccionados y acumula sus resultados
+ */
+class BenchmarkRunner {
+private:
+    const BenchmarkOptions& options;   ///< Parámetros de la ejecución
+    vector<BenchmarkResult> results;   ///< Resultados acumulados
+
+    /**
+     * @brief Indica si un caso pasa el filtro
+     * @param name Nombre del caso
+     * @return true si debe ejecutarse
+     */
+    bool selected(const string& name) const {
+        return options.filter.empty() || name.find(options.filter) != string::npos;
+    }
+
+    /**
+     * @brief Ruta de un archivo temporal dentro de tmpdir
+     * @param name Nombre del archivo
+     * @return Ruta completa
+     */
+    string tempPath(const string& name) const {
+        return options.tmpdir + "/" + name;
+    }
+
+    /**
+     * @brief Ejecuta un caso options.repeat veces y guarda el resultado
+     * @param name Nombre del caso
+     * @param params Parámetros como objeto JSON
+     * @param items Elementos procesados por repetición
+     * @param bytes Bytes procesados por repetición
+     * @param once Ejecuta una repetición y devuelve su tiempo medido en segundos, o un
+     *        valor negativo si falló (el caso se informa y no se guarda)
+     */
+    void record(const string& name, const string& params, uint64_t items, uint64_t bytes,
+                const function<double()>& once) {
+        BenchmarkResult result;
+        result.name = name;
+        result.params = params;
+        result.items = items;
+        result.bytes = bytes;
+        for (int r = 0; r < options.repeat; r++) {
+            double seconds = once();
+            if (seconds < 0) {
+                cerr << "Error: " << name << " " << params << ": falló; caso omitido" << endl;
+                return;
+            }
+            result.seconds.push_back(seconds);
+        }
+        sort(result.seconds.begin(), result.seconds.end());
+
+        cerr << name << " " << params << ": " << result.seconds[0] * 1e3 << " ms" << endl;
+        results.push_back(result);
+    }
+
+    void circularBufferCases();
+    void fileSourceCases();
+    void mergeSortCases();
+    void telemetryCases();
+
+public:
+    /**
+     * @brief Constructor
+     * @param opts Parámetros de la ejecución
+     */
+    BenchmarkRunner(const BenchmarkOptions& opts) : options(opts) {}
+
+    /**
+     * @brief Ejecuta todos los casos seleccionados
+     */
+    void run() {
+        circularBufferCases();
+        fileSourceCases();
+        mergeSortCases();
+        telemetryCases();
+    }
+
+    /**
+     * @brief Escribe los resultados como JSON
+     * @param out Flujo de salida
+     */
+    void writeJson(ostream& out) const;
+};
+
+void BenchmarkRunner::circularBufferCases() {
+    vector<int> sizes = options.quick ? vector<int>{1024, 65536}
+                                      : vector<int>{1024, 16384, 262144, 1048576};
+    const SortEngine engines[] = {SortEngine::RADIX, SortEngine::INTRO, SortEngine::MERGE,
+                                  SortEngine::INSERTION};
+
+    for (int size : sizes) {
+        vector<int> values = randomValues(size, 42);
+        string sizeParam = "{\"size\": " + to_string(size) + "}";
+        CircularBuffer buffer(size);
+
+        if (selected("circular_buffer.insert")) {
+            record("circular_buffer.insert", sizeParam, size, 0, [&]() {
+                buffer.clear();
+                return timeIt([&]() {
+                    for (int i = 0; i < size; i++) buffer.insert(values[i]);
+                });
+            });
+        }
+
+        if (selected("circular_buffer.get_data")) {
+            vector<int> out(size);
+            record("circular_buffer.get_data", sizeParam, size, size * sizeof(int), [&]() {
+                buffer.clear();
+                for (int i = 0; i < size; i++) buffer.insert(values[i]);
+                return timeIt([&]() { buffer.getData(out.data(), size); });
+            });
+        }
+
+        if (selected("circular_buffer.clear")) {
+            record("circular_buffer.clear", sizeParam, size, 0, [&]() {
+                for (int i = 0; i < size; i++) buffer.insert(values[i]);
+                return timeIt([&]() { buffer.clear(); });
+            });
+        }
+
+        for (SortEngine engine : engines) {
+            // Insertion es cuadrático: solo en tamaños pequeños
+            if (engine == SortEngine::INSERTION && size > 16384) continue;
+            if (!selected("circular_buffer.sort")) continue;
+
+            string params = "{\"size\": " + to_string(size) + ", \"engine\": \"" +
+                            sortEngineName(engine) + "\"}";
+            buffer.setSortEngine(engine);
+            record("circular_buffer.sort", params, size, 0, [&]() {
+                buffer.clear();
+                for (int i = 0; i < size; i++) buffer.insert(values[i]);
+                return timeIt([&]() { buffer.sort(); });
+            });
+        }
+    }
+}
+
+void BenchmarkRunner::fileSourceCases() {
+    int count = options.quick ? (1 << 18) : (1 << 22);
+    vector<int> values = randomValues(count, 7);
+    sort(values.begin(), values.end());
+
+    const ChunkFormat formats[] = {ChunkFormat::TEXT, ChunkFormat::BINARY, ChunkFormat::DELTA};
+    for (ChunkFormat format : formats) {
+        const char* formatName = chunkFormatName(format);
+        string filename = tempPath(string("bench_source_") + formatName + ".tmp");
+        if (!writeChunk(filename, values.data(), count, format)) {
+            cerr << "Error: No se pudo escribir " << filename << "; casos de " << formatName
+                 << " omitidos" << endl;
+            remove(filename.c_str());
+            continue;
+        }
+        uint64_t bytes = fileSize(filename);
+        string params = "{\"records\": " + to_string(count) + ", \"format\": \"" + formatName + "\"}";
+
+        if (selected("file_source.get_next")) {
+            record("file_source.get_next", params, count, bytes, [&]() {
+                return timeIt([&]() {
+                    FileSource source(filename);
+                    volatile int sink = 0;
+                    while (source.hasMoreData()) sink = source.getNext();
+                    (void)sink;
+                });
+            });
+        }
+
+        if (selected("mapped_file_source.get_next")) {
+            record("mapped_file_source.get_next", params, count, bytes, [&]() {
+                return timeIt([&]() {
+                    MappedFileSource source(filename);
+                    volatile int sink = 0;
+                    while (source.hasMoreData()) sink = source.getNext();
+                    (void)sink;
+                });
+            });
+        }
+
+        if (selected("file_source.read")) {
+            vector<int> batch(4096);
+            record("file_source.read", params, count, bytes, [&]() {
+                return timeIt([&]() {
+                    FileSource source(filename);
+                    while (source.read(batch.data(), batch.size()) > 0) {}
+                });
+            });
+        }
+
+        if (selected("mapped_file_source.read")) {
+            vector<int> batch(4096);
+            record("mapped_file_source.read", params, count, bytes, [&]() {
+                return timeIt([&]() {
+                    MappedFileSource source(filename);
+                    while (source.read(batch.data(), batch.size()) > 0) {}
+                });
+            });
+        }
+
+        remove(filename.c_str());
+    }
+}
+
+void BenchmarkRunner::mergeSortCases() {
+    if (!selected("merge_sort.merge")) return;
+
+    vector<int> fanIns = options.quick ? vector<int>{4, 64}
+                                       : vector<int>{4, 16, 64, 256, 1024};
+    vector<int> totals = options.quick ? vector<int>{1 << 18}
+                                       : vector<int>{1 << 20, 1 << 23};
+    int fdLimit = MergePlanner::openFileLimit();
+
+    for (int total : totals) {
+        vector<int> values = randomValues(total, 99);
+
+        for (int k : fanIns) {
+            if (k > total || k + 16 > fdLimit) {
+                cerr << "merge_sort.merge K=" << k << ": omitido (límite de archivos abiertos)" << endl;
+                continue;
+            }
+
+            // K corridas ordenadas de tamaño casi igual, en binario y en bloques delta
+            const ChunkFormat formats[] = {ChunkFormat::BINARY, ChunkFormat::DELTA};
+            for (ChunkFormat format : formats) {
+                vector<string> runs;
+                uint64_t bytes = 0;
+                bool written = true;
+                for (int i = 0; i < k && written; i++) {
+                    int begin = static_cast<int>(static_cast<long long>(total) * i / k);
+                    int end = static_cast<int>(static_cast<long long>(total) * (i + 1) / k);
+                    vector<int> run(values.begin() + begin, values.begin() + end);
+                    sort(run.begin(), run.end());
+                    string filename = tempPath("bench_run_" + to_string(i) + ".tmp");
+                    written = writeChunk(filename, run.data(), static_cast<int>(run.size()), format);
+                    bytes += fileSize(filename);
+                    runs.push_back(filename);
+                }
+
+                string output = tempPath("bench_merged.tmp");
+                string params = "{\"k\": " + to_string(k) + ", \"records\": " + to_string(total) +
+                                ", \"format\": \"" + chunkFormatName(format) + "\"}";
+                if (!written) {
+                    cerr << "Error: No se pudo escribir " << runs.back()
+                         << "; merge_sort.merge " << params << " omitido" << endl;
+                } else {
+                    record("merge_sort.merge", params, total, bytes, [&]() {
+                        bool merged = false;
+                        double seconds = timeIt([&]() {
+                            MergeSort mergeSort(runs, output, BlockWriter::DEFAULT_BLOCK_SIZE,
+                                                format);
+                            merged = mergeSort.merge();
+                        });
+                        return merged ? seconds : -1.0;
+                    });
+                }
+
+                remove(output.c_str());
+                for (const string& filename : runs) {
+                    remove(filename.c_str());
+                }
+            }
+        }
+    }
+}
+
+void BenchmarkRunner::telemetryCases() {
+    typedef BasicCircularBuffer<TelemetryRecord, TimestampKey> TelemetryBuffer;
+    typedef BasicMergeSort<TelemetryRecord, TimestampKey> TelemetryMerge;
+
+    int size = options.quick ? 65536 : 1048576;
+    vector<TelemetryRecord> records = randomTelemetry(size, 42);
+
+    if (selected("telemetry.sort")) {
+        const SortEngine engines[] = {SortEngine::RADIX, SortEngine::INTRO, SortEngine::MERGE};
+        TelemetryBuffer buffer(size);
+
+        for (SortEngine engine : engines) {
+            string params = "{\"size\": " + to_string(size) + ", \"engine\": \"" +
+                            sortEngineName(engine) + "\", \"key\": \"timestamp\"}";
+            buffer.setSortEngine(engine);
+            record("telemetry.sort", params, size, size * sizeof(TelemetryRecord), [&]() {
+                buffer.clear();
+                for (int i = 0; i < size; i++) buffer.insert(records[i]);
+                return timeIt([&]() { buffer.sort(); });
+            });
+        }
+    }
+
+    if (selected("telemetry.merge")) {
+        const int k = 16;
+        vector<string> runs;
+        uint64_t bytes = 0;
+        bool written = true;
+        for (int i = 0; i < k && written; i++) {
+            int begin = static_cast<int>(static_cast<long long>(size) * i / k);
+            int end = static_cast<int>(static_cast<long long>(size) * (i + 1) / k);
+            vector<TelemetryRecord> run(records.begin() + begin, records.begin() + end);
+            sort(run.begin(), run.end(), KeyLess<TimestampKey>());
+            string filename = tempPath("bench_telemetry_" + to_string(i) + ".tmp");
+            written = writeChunk<TelemetryRecord, TimestampKey>(filename, run.data(),
+                                                                static_cast<int>(run.size()),
+                                                                ChunkFormat::BINARY);
+            bytes += fileSize(filename);
+            runs.push_back(filename);
+        }
+
+        string output = tempPath("bench_telemetry_merged.tmp");
+        string params = "{\"k\": " + to_string(k) + ", \"records\": " + to_string(size) +
+                        ", \"format\": \"binary\", \"key\": \"timestamp\"}";
+        if (!written) {
+            cerr << "Error: No se pudo escribir " << runs.back() << "; telemetry.merge "
+                 << params << " omitido" << endl;
+        } else {
+            record("telemetry.merge", params, size, bytes, [&]() {
+                bool merged = false;
+                double seconds = timeIt([&]() {
+                    TelemetryMerge merger(runs, output, BlockWriter::DEFAULT_BLOCK_SIZE,
+                                          ChunkFormat::BINARY);
+                    merged = merger.merge();
+                });
+                return merged ? seconds : -1.0;
+            });
+        }
+
+        remove(output.c_str());
+        for (const string& filename : runs) {
+            remove(filename.c_str());
+        }
+    }
+}
+
+void BenchmarkRunner::writeJson(ostream& out) const {
+    out << "{\n";
+    out << "  \"benchmark\": \"esort_bench\",\n";
+    out << "  \"timestamp\": " << static_cast<long long>(time(NULL)) << ",\n";
+    out << "  \"repeat\": " << options.repeat << ",\n";
+    out << "  \"quick\": " << (options.quick ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& r = results[i];
+        double best = r.seconds.front();
+        double median = r.seconds[r.seconds.size() / 2];
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"name\": \"" << r.name << "\", \"params\": " << r.params
+            << ", \"items\": " << r.items << ", \"bytes\": " << r.bytes
+            << ", \"best_s\": " << jsonNumber(best)
+            << ", \"median_s\": " << jsonNumber(median)
+            << ", \"ns_per_item\": " << jsonNumber(best * 1e9 / r.items)
+            << ", \"items_per_s\": " << jsonNumber(r.items / best);
+        if (r.bytes > 0) {
+            out << ", \"mb_per_s\": " << jsonNumber(r.bytes / best / (1024.0 * 1024.0));
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--quick") options.quick = true;
+        else if (arg == "--repeat" && hasValue) options.repeat = max(1, atoi(argv[++i]));
+        else if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--tmpdir" && hasValue) options.tmpdir = argv[++i];
+        else if (arg == "--output" && hasValue) options.output = argv[++i];
+        else {
+            cerr << "Uso: esort_bench [--quick] [--repeat N] [--filter TEXTO] "
+                 << "[--tmpdir DIR] [--output ARCHIVO]" << endl;
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(options);
+    runner.run();
+
+    if (options.output.empty()) {
+        runner.writeJson(cout);
+    } else {
+        ofstream file(options.output);
+        if (!file) {
+            cerr << "Error: No se pudo crear " << options.output << endl;
+            return 1;
+        }
+        runner.writeJson(file);
+    }
+    return 0;
+}
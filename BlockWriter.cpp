@@ -0,0 +1,172 @@
+/**
+ * @file BlockWriter.cpp
+ * @brief Implementación de BlockWriter
+ */
+
+#include "BlockWriter.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/// Pares de dígitos "00".."99" para formatear dos dígitos por división
+const char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+} // namespace
+
+BlockWriter::BlockWriter(const std::string& filename, size_t blockBytes, bool background)
+    : file(nullptr), active(0), blockSize(blockBytes < 64 ? 64 : blockBytes), used(0),
+      totalBytes(0), async(background), failed(false),
+      pendingData(nullptr), pendingSize(0), stopping(false) {
+    buffers[0] = buffers[1] = nullptr;
+
+    file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: No se pudo crear el archivo " << filename << std::endl;
+        return;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    // Sin hilo no hay bloque en vuelo: basta un buffer
+    buffers[0] = new char[blockSize];
+    buffers[1] = async ? new char[blockSize] : nullptr;
+
+    if (async) {
+        worker = std::thread(&BlockWriter::writerLoop, this);
+    }
+}
+
+bool BlockWriter::isOpen() const {
+    return file != nullptr;
+}
+
+size_t BlockWriter::formatInt(int value, char* out) {
+    char tmp[12];
+    char* p = tmp + sizeof(tmp);
+    *--p = '\n';
+
+    // Magnitud sin signo para que INT_MIN no desborde
+    unsigned int v = value < 0 ? 0u - static_cast<unsigned int>(value)
+                               : static_cast<unsigned int>(value);
+    while (v >= 100) {
+        unsigned int idx = (v % 100) * 2;
+        v /= 100;
+        *--p = DIGIT_PAIRS[idx + 1];
+        *--p = DIGIT_PAIRS[idx];
+    }
+    if (v >= 10) {
+        *--p = DIGIT_PAIRS[v * 2 + 1];
+        *--p = DIGIT_PAIRS[v * 2];
+    } else {
+        *--p = static_cast<char>('0' + v);
+    }
+    if (value < 0) {
+        *--p = '-';
+    }
+
+    size_t len = tmp + sizeof(tmp) - p;
+    std::memcpy(out, p, len);
+    return len;
+}
+
+void BlockWriter::write(const void* data, size_t size) {
+    if (file == nullptr) return;
+
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        size_t space = blockSize - used;
+        size_t chunk = size < space ? size : space;
+        std::memcpy(buffers[active] + used, bytes, chunk);
+        used += chunk;
+        bytes += chunk;
+        size -= chunk;
+        if (used == blockSize) {
+            flushBlock();
+        }
+    }
+}
+
+void BlockWriter::writeToDisk(const char* data, size_t size) {
+    if (std::fwrite(data, 1, size, file) != size) {
+        failed = true;
+    }
+}
+
+void BlockWriter::flushBlock() {
+    if (file == nullptr || used == 0) return;
+
+    if (!async) {
+        writeToDisk(buffers[active], used);
+    } else {
+        std::unique_lock<std::mutex> lock(mtx);
+        // Espera a que el hilo termine el bloque anterior (que usa el otro buffer)
+        cv.wait(lock, [this] { return pendingData == nullptr; });
+        pendingData = buffers[active];
+        pendingSize = used;
+        lock.unlock();
+        cv.notify_all();
+        active = 1 - active;
+    }
+
+    totalBytes += used;
+    used = 0;
+}
+
+void BlockWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        cv.wait(lock, [this] { return pendingData != nullptr || stopping; });
+        if (pendingData == nullptr && stopping) {
+            break;
+        }
+
+        const char* data = pendingData;
+        size_t size = pendingSize;
+        lock.unlock();
+        writeToDisk(data, size);
+        lock.lock();
+
+        pendingData = nullptr;
+        cv.notify_all();
+    }
+}
+
+bool BlockWriter::close() {
+    if (file == nullptr) return !failed;
+
+    flushBlock();
+
+    if (async && worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+
+    delete[] buffers[0];
+    delete[] buffers[1];
+    buffers[0] = buffers[1] = nullptr;
+
+    return !failed;
+}
+
+BlockWriter::~BlockWriter() {
+    close();
+}
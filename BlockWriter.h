@@ -0,0 +1,130 @@
+/**
+ * @file BlockWriter.h
+ * @brief Escritor de archivos por bloques grandes con doble buffer
+ * @details Acumula la salida en bloques de tamaño configurable y los escribe en disco
+ *          desde un hilo en segundo plano mientras se llena el siguiente bloque
+ */
+
+#ifndef BLOCKWRITER_H
+#define BLOCKWRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @class BlockWriter
+ * @brief Sumidero de salida con bloques grandes y formateo manual de enteros
+ * @details Reemplaza a std::ofstream + std::endl (un flush por dato). Cada bloque lleno
+ *          se entrega al hilo escritor y el llamador continúa en el otro buffer; solo
+ *          espera si el hilo todavía no terminó de escribir el bloque anterior.
+ */
+class BlockWriter {
+private:
+    std::FILE* file;            ///< Archivo de salida (sin buffer de stdio)
+    char* buffers[2];           ///< Doble buffer: uno se llena mientras el otro se escribe
+    int active;                 ///< Índice del buffer que se está llenando
+    size_t blockSize;           ///< Tamaño de cada bloque en bytes
+    size_t used;                ///< Bytes ocupados en el buffer activo
+    uint64_t totalBytes;        ///< Bytes entregados al escritor desde la apertura
+    bool async;                 ///< true si los bloques se escriben en un hilo aparte
+    bool failed;                ///< true si alguna escritura a disco falló
+
+    std::thread worker;         ///< Hilo que escribe los bloques llenos
+    std::mutex mtx;             ///< Protege pendingData/pendingSize/stopping
+    std::condition_variable cv; ///< Señala bloques pendientes y bloques terminados
+    const char* pendingData;    ///< Bloque pendiente de escribir (nullptr si no hay)
+    size_t pendingSize;         ///< Tamaño del bloque pendiente
+    bool stopping;              ///< Solicita al hilo escritor que termine
+
+    BlockWriter(const BlockWriter&);            ///< No copiable
+    BlockWriter& operator=(const BlockWriter&); ///< No asignable
+
+    /**
+     * @brief Bucle del hilo escritor
+     */
+    void writerLoop();
+
+    /**
+     * @brief Entrega el buffer activo al disco y cambia al otro buffer
+     */
+    void flushBlock();
+
+    /**
+     * @brief Escribe un bloque directamente en el archivo
+     * @param data Bytes a escribir
+     * @param size Número de bytes
+     */
+    void writeToDisk(const char* data, size_t size);
+
+public:
+    static const size_t DEFAULT_BLOCK_SIZE = 1 << 20; ///< 1 MiB por bloque
+
+    /**
+     * @brief Constructor que crea el archivo de salida
+     * @param filename Nombre del archivo a crear (se trunca si existe)
+     * @param blockBytes Tamaño de cada bloque en bytes
+     * @param background true para escribir los bloques desde un hilo en segundo plano;
+     *                   false escribe cada bloque en el momento, con un solo buffer y sin hilo
+     */
+    BlockWriter(const std::string& filename, size_t blockBytes = DEFAULT_BLOCK_SIZE,
+                bool background = true);
+
+    /**
+     * @brief Verifica si el archivo se abrió correctamente
+     * @return true si el archivo está abierto
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Agrega bytes arbitrarios a la salida
+     * @param data Bytes a escribir
+     * @param size Número de bytes
+     */
+    void write(const void* data, size_t size);
+
+    /**
+     * @brief Agrega un entero en decimal seguido de '\n'
+     * @param value Valor a escribir
+     * @details Formatea a mano (dos dígitos por iteración) sin pasar por iostream
+     */
+    void writeInt(int value) {
+        if (blockSize - used < 12) {
+            flushBlock();
+        }
+        used += formatInt(value, buffers[active] + used);
+    }
+
+    /**
+     * @brief Formatea un entero en decimal terminado en '\n'
+     * @param value Valor a formatear
+     * @param out Destino con al menos 12 bytes libres
+     * @return Número de bytes escritos
+     */
+    static size_t formatInt(int value, char* out);
+
+    /**
+     * @brief Bytes escritos hasta ahora (incluye los que siguen en buffer)
+     * @return Desplazamiento actual dentro del archivo
+     */
+    uint64_t bytesWritten() const {
+        return totalBytes + used;
+    }
+
+    /**
+     * @brief Escribe lo pendiente, detiene el hilo y cierra el archivo
+     * @return true si todas las escrituras fueron exitosas
+     */
+    bool close();
+
+    /**
+     * @brief Destructor que cierra el archivo si sigue abierto
+     */
+    ~BlockWriter();
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file ChunkFile.cpp
+ * @brief Implementación de la escritura y lectura de encabezados de chunks
+ */
+
+#include "ChunkFile.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+bool isChunkHeader(const ChunkHeader& header) {
+    return std::memcmp(header.magic, CHUNK_MAGIC, sizeof(CHUNK_MAGIC)) == 0 &&
+           (header.version == CHUNK_VERSION || header.version == CHUNK_VERSION_DELTA);
+}
+
+bool isDeltaChunk(const ChunkHeader& header) {
+    return header.version == CHUNK_VERSION_DELTA;
+}
+
+const char* chunkFormatName(ChunkFormat format) {
+    switch (format) {
+        case ChunkFormat::TEXT:   return "text";
+        case ChunkFormat::BINARY: return "binary";
+        case ChunkFormat::DELTA:  return "delta";
+    }
+    return "unknown";
+}
+
+void makeChunkHeader(ChunkHeader& header, uint64_t count, int64_t minKey, int64_t maxKey,
+                     uint16_t recordWidth, ChunkFormat format) {
+    std::memcpy(header.magic, CHUNK_MAGIC, sizeof(CHUNK_MAGIC));
+    header.version = format == ChunkFormat::DELTA ? CHUNK_VERSION_DELTA : CHUNK_VERSION;
+    header.keyWidth = recordWidth;
+    header.count = count;
+    header.minKey = minKey;
+    header.maxKey = maxKey;
+}
+
+bool readChunkHeader(const std::string& filename, ChunkHeader& header) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    return isChunkHeader(header);
+}
+
+
+bool patchChunkHeader(const std::string& filename, const ChunkHeader& header) {
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo reabrir el chunk " << filename << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    return !file.fail();
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+/**
+ * @file ChunkFile.h
+ * @brief Formatos de archivo para los chunks (corridas) generados en la Fase 1
+ * @details Define el formato binario con encabezado y la escritura de chunks en texto,
+ *          binario o binario comprimido por bloques delta
+ */
+
+#ifndef CHUNKFILE_H
+#define CHUNKFILE_H
+
+#include "BlockWriter.h"
+#include "DeltaCodec.h"
+#include "Record.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum ChunkFormat
+ * @brief Formato en disco de un chunk ordenado
+ */
+enum class ChunkFormat {
+    TEXT,    ///< Un registro por línea (ver RecordText; útil para depuración)
+    BINARY,  ///< Encabezado ChunkHeader seguido de los registros en binario
+    DELTA    ///< Encabezado ChunkHeader seguido de bloques delta + varint (ver DeltaCodec.h)
+};
+
+/**
+ * @struct ChunkHeader
+ * @brief Encabezado de 32 bytes de un chunk binario
+ * @details Los campos se escriben en el orden de bytes del host (little-endian en x86/ARM)
+ */
+struct ChunkHeader {
+    char magic[4];        ///< Firma "ESRT"
+    uint16_t version;     ///< Versión del formato (CHUNK_VERSION o CHUNK_VERSION_DELTA)
+    uint16_t keyWidth;    ///< Tamaño en bytes de cada registro (4 para int, 16 para TelemetryRecord)
+    uint64_t count;       ///< Número de registros del chunk
+    int64_t minKey;       ///< Clave mínima del chunk
+    int64_t maxKey;       ///< Clave máxima del chunk
+};
+
+static const char CHUNK_MAGIC[4] = {'E', 'S', 'R', 'T'}; ///< Firma de los chunks binarios
+static const uint16_t CHUNK_VERSION = 1;                 ///< Registros en binario sin comprimir
+static const uint16_t CHUNK_VERSION_DELTA = 2;           ///< Registros en bloques delta + varint
+
+/**
+ * @brief Inicializa un encabezado de chunk binario
+ * @param header Encabezado a completar
+ * @param count Número de registros
+ * @param minKey Clave mínima
+ * @param maxKey Clave máxima
+ * @param recordWidth Tamaño en bytes de cada registro
+ * @param format BINARY o DELTA (determina la versión del encabezado)
+ */
+void makeChunkHeader(ChunkHeader& header, uint64_t count, int64_t minKey, int64_t maxKey,
+                     uint16_t recordWidth = sizeof(int), ChunkFormat format = ChunkFormat::BINARY);
+
+/**
+ * @brief Escribe un chunk ordenado en disco
+ * @param filename Nombre del archivo a crear (ej: "chunk_01.tmp")
+ * @param data Registros ordenados según KeyOf
+ * @param count Número de registros
+ * @param format Formato del archivo (texto o binario)
+ * @param blockSize Tamaño máximo de bloque del BlockWriter usado para escribir
+ * @return true si el archivo se escribió completo
+ * @details El encabezado binario guarda sizeof(T) y las claves del primer y último registro;
+ *          en DELTA los registros se escriben en bloques de DELTA_BLOCK_RECORDS.
+ *          Escribe de forma síncrona desde el hilo llamador (los trabajadores del pool ya
+ *          corren aparte) con un bloque del tamaño estimado del chunk: un chunk pequeño no
+ *          lanza un hilo ni reserva 2 MiB de buffers.
+ */
+template<typename T, typename KeyOf = IdentityKey<T> >
+bool writeChunk(const std::string& filename, const T* data, int count, ChunkFormat format,
+                size_t blockSize = BlockWriter::DEFAULT_BLOCK_SIZE) {
+    // Cota holgada del tamaño: binario, delta y texto caben en ~3 * sizeof(T) por registro
+    size_t records = static_cast<size_t>(count > 0 ? count : 0);
+    size_t estimate = sizeof(ChunkHeader) + 3 * sizeof(T) * records + 64;
+    BlockWriter chunkFile(filename, estimate < blockSize ? estimate : blockSize, false);
+    if (!chunkFile.isOpen()) {
+        return false;
+    }
+
+    if (format != ChunkFormat::TEXT) {
+        ChunkHeader header;
+        makeChunkHeader(header, count,
+                        count > 0 ? static_cast<int64_t>(KeyOf::key(data[0])) : 0,
+                        count > 0 ? static_cast<int64_t>(KeyOf::key(data[count - 1])) : 0,
+                        sizeof(T), format);
+        chunkFile.write(&header, sizeof(header));
+
+        if (format == ChunkFormat::DELTA) {
+            DeltaBlockEncoder<T> encoder;
+            for (int i = 0; i < count; i++) {
+                encoder.append(chunkFile, data[i]);
+            }
+            encoder.flush(chunkFile);
+        } else {
+            chunkFile.write(data, sizeof(T) * count);
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            RecordText<T>::write(chunkFile, data[i]);
+        }
+    }
+
+    return chunkFile.close();
+}
+
+/**
+ * @brief Reescribe el encabezado al inicio de un chunk binario ya escrito
+ * @param filename Nombre del archivo
+ * @param header Encabezado definitivo
+ * @return true si se pudo reescribir
+ * @details Lo usa el merge, que solo conoce count/min/max al terminar de escribir
+ */
+bool patchChunkHeader(const std::string& filename, const ChunkHeader& header);
+
+/**
+ * @brief Lee el encabezado de un chunk binario
+ * @param filename Nombre del archivo
+ * @param header Encabezado leído
+ * @return true si el archivo existe y tiene la firma de chunk binario
+ */
+bool readChunkHeader(const std::string& filename, ChunkHeader& header);
+
+/**
+ * @brief Verifica si un encabezado tiene la firma y versión esperadas
+ * @param header Encabezado a validar
+ * @return true si es un encabezado de chunk binario válido (comprimido o no)
+ */
+bool isChunkHeader(const ChunkHeader& header);
+
+/**
+ * @brief Indica si un chunk binario guarda sus registros en bloques delta
+ * @param header Encabezado ya validado con isChunkHeader()
+ * @return true si la versión es CHUNK_VERSION_DELTA
+ */
+bool isDeltaChunk(const ChunkHeader& header);
+
+/**
+ * @brief Devuelve el nombre legible de un formato de chunk
+ * @param format Formato
+ * @return Nombre del formato (ej: "delta")
+ */
+const char* chunkFormatName(ChunkFormat format);
+
+#endif
@@ -0,0 +1,402 @@
+/**
+ * @file ChunkManifest.cpp
+ * @brief Implementación de ChunkManifest
+ */
+
+#include "ChunkManifest.h"
+#include "ChunkFile.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+const char MANIFEST_MAGIC[] = "esort-manifest";  ///< Inicio de la primera línea
+const int MANIFEST_VERSION = 1;                    ///< Versión del formato
+
+/**
+ * @brief Interpreta el nombre de un formato de chunk (inversa de chunkFormatName)
+ * @param name Nombre
+ * @param format Formato resultante
+ * @return false si el nombre no es un formato
+ */
+bool parseChunkFormat(const std::string& name, ChunkFormat& format) {
+    const ChunkFormat formats[] = {ChunkFormat::TEXT, ChunkFormat::BINARY, ChunkFormat::DELTA};
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+        if (name == chunkFormatName(formats[i])) {
+            format = formats[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Interpreta la primera línea del manifiesto
+ * @param line Línea
+ * @param format Formato de los chunks
+ * @param aggregate Chunks de pares (valor, repeticiones)
+ * @return false si no es una cabecera válida
+ */
+bool parseHeader(const std::string& line, ChunkFormat& format, bool& aggregate) {
+    std::istringstream fields(line);
+    std::string magic;
+    int version;
+    std::string formatField;
+    std::string aggregateField;
+    if (!(fields >> magic >> version >> formatField >> aggregateField) ||
+        magic != MANIFEST_MAGIC || version != MANIFEST_VERSION ||
+        formatField.compare(0, 7, "format=") != 0 ||
+        !parseChunkFormat(formatField.substr(7), format)) {
+        return false;
+    }
+    if (aggregateField != "aggregate=0" && aggregateField != "aggregate=1") {
+        return false;
+    }
+    aggregate = aggregateField == "aggregate=1";
+    return true;
+}
+
+/**
+ * @struct Crc32Table
+ * @brief Tabla del CRC-32 reflejado (polinomio 0xEDB88320)
+ */
+struct Crc32Table {
+    uint32_t entries[256];
+
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t size) {
+    static const Crc32Table table;
+    for (size_t i = 0; i < size; i++) {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+/**
+ * @brief Fuerza a disco el contenido de un archivo ya cerrado
+ * @param filename Archivo a sincronizar
+ * @return false si no se pudo abrir o sincronizar
+ */
+bool syncFile(const std::string& filename) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    bool ok = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    return ok;
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+
+/**
+ * @brief Fuerza a disco la entrada de directorio de un archivo recién creado
+ * @param filename Archivo cuyo directorio se sincroniza
+ * @details En Windows los metadatos del directorio se escriben con el archivo
+ */
+void syncDirectoryOf(const std::string& filename) {
+#ifndef _WIN32
+    size_t slash = filename.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : filename.substr(0, slash + 1);
+    int fd = open(dir.c_str(), O_RDONLY);
+    if (fd != -1) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)filename;
+#endif
+}
+
+} // namespace
+
+ChunkManifest::ChunkManifest(const std::string& manifestPath)
+    : path(manifestPath), file(nullptr), sealed(false), merged(false),
+      chunkFormat(ChunkFormat::BINARY), aggregated(false) {}
+
+bool ChunkManifest::appendLine(const std::string& line) {
+    if (file == nullptr) return false;
+
+    std::string text = line + "\n";
+    bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size() &&
+              std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    if (!ok) {
+        std::cerr << "Error: No se pudo escribir el manifiesto " << path << std::endl;
+    }
+    return ok;
+}
+
+bool ChunkManifest::create(ChunkFormat format, bool aggregate) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (file != nullptr) std::fclose(file);
+
+    entries.clear();
+    sealed = false;
+    merged = false;
+    mergedOutput.clear();
+    chunkFormat = format;
+    aggregated = aggregate;
+
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Error: No se pudo crear el manifiesto " << path << std::endl;
+        return false;
+    }
+    std::ostringstream header;
+    header << MANIFEST_MAGIC << " " << MANIFEST_VERSION << " format=" << chunkFormatName(format)
+           << " aggregate=" << (aggregate ? 1 : 0);
+    bool ok = appendLine(header.str());
+    syncDirectoryOf(path);
+    return ok;
+}
+
+bool ChunkManifest::load() {
+    std::lock_guard<std::mutex> lock(mtx);
+    entries.clear();
+    sealed = false;
+    merged = false;
+    mergedOutput.clear();
+
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    if (!in.is_open() || !std::getline(in, line) || !parseHeader(line, chunkFormat, aggregated)) {
+        std::cerr << "Error: " << path << " no existe o no es un manifiesto de E-Sort" << std::endl;
+        return false;
+    }
+
+    bool tornTail = false;
+    while (std::getline(in, line)) {
+        if (in.eof()) {
+            // Última línea sin '\n': la escritura se interrumpió a la mitad
+            std::cerr << "Advertencia: Línea incompleta al final de " << path
+                      << " (ignorada)" << std::endl;
+            tornTail = true;
+            break;
+        }
+
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+
+        if (kind == "chunk") {
+            ManifestEntry entry;
+            if (fields >> entry.index >> entry.records >> entry.bytes >> std::hex >> entry.checksum) {
+                fields >> std::ws;
+                std::getline(fields, entry.filename);
+                if (!entry.filename.empty()) {
+                    entries.push_back(entry);
+                    continue;
+                }
+            }
+        } else if (kind == "sealed") {
+            sealed = true;
+            continue;
+        } else if (kind == "merged") {
+            uint64_t records;
+            if (fields >> records) {
+                fields >> std::ws;
+                std::getline(fields, mergedOutput);
+                merged = true;
+                continue;
+            }
+        }
+        std::cerr << "Advertencia: Línea inválida en " << path << ": " << line << std::endl;
+    }
+    in.close();
+
+    std::sort(entries.begin(), entries.end(),
+              [](const ManifestEntry& a, const ManifestEntry& b) { return a.index < b.index; });
+
+    file = std::fopen(path.c_str(), "ab");
+    if (file == nullptr) {
+        std::cerr << "Error: No se pudo abrir el manifiesto " << path << std::endl;
+        return false;
+    }
+    if (tornTail) {
+        // Cerrar la línea cortada para que la siguiente quede separada
+        std::fputc('\n', file);
+    }
+    return true;
+}
+
+bool ChunkManifest::addChunk(int index, const std::string& filename, uint64_t records) {
+    ManifestEntry entry;
+    entry.index = index;
+    entry.records = records;
+    entry.filename = filename;
+
+    // El chunk debe estar completo en disco antes de que su línea exista
+    if (!syncFile(filename) || !fileChecksum(filename, entry.bytes, entry.checksum)) {
+        std::cerr << "Error: No se pudo sincronizar el chunk " << filename << std::endl;
+        return false;
+    }
+    syncDirectoryOf(filename);
+
+    std::ostringstream line;
+    line << "chunk " << index << " " << records << " " << entry.bytes << " "
+         << std::hex << std::setw(8) << std::setfill('0') << entry.checksum << std::dec
+         << " " << filename;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!appendLine(line.str())) {
+        return false;
+    }
+    entries.push_back(entry);
+    return true;
+}
+
+bool ChunkManifest::seal() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (sealed) return true;
+    sealed = appendLine("sealed");
+    return sealed;
+}
+
+bool ChunkManifest::markMerged(const std::string& outputFile, uint64_t records) {
+    std::lock_guard<std::mutex> lock(mtx);
+    merged = appendLine("merged " + std::to_string(records) + " " + outputFile);
+    if (merged) mergedOutput = outputFile;
+    return merged;
+}
+
+bool ChunkManifest::validate(std::vector<std::string>& valid, uint64_t& validRecords) const {
+    std::vector<ManifestEntry> sorted = getEntries();
+    std::sort(sorted.begin(), sorted.end(),
+              [](const ManifestEntry& a, const ManifestEntry& b) { return a.index < b.index; });
+
+    valid.clear();
+    validRecords = 0;
+    bool allValid = true;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const ManifestEntry& entry = sorted[i];
+        uint64_t bytes;
+        uint32_t checksum;
+
+        if (!fileChecksum(entry.filename, bytes, checksum)) {
+            std::cerr << "Error: Falta el chunk " << entry.filename << std::endl;
+            allValid = false;
+            continue;
+        }
+        if (bytes != entry.bytes || checksum != entry.checksum) {
+            std::cerr << "Error: El chunk " << entry.filename
+                      << " no coincide con el manifiesto (tamaño o CRC)" << std::endl;
+            allValid = false;
+            continue;
+        }
+
+        ChunkHeader header;
+        if (readChunkHeader(entry.filename, header) && header.count != entry.records) {
+            std::cerr << "Error: El chunk " << entry.filename << " declara " << header.count
+                      << " registros y el manifiesto " << entry.records << std::endl;
+            allValid = false;
+            continue;
+        }
+        valid.push_back(entry.filename);
+        validRecords += entry.records;
+    }
+    return allValid;
+}
+
+int ChunkManifest::nextIndex() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    int next = 1;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].index >= next) next = entries[i].index + 1;
+    }
+    return next;
+}
+
+uint64_t ChunkManifest::totalRecords() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    uint64_t total = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        total += entries[i].records;
+    }
+    return total;
+}
+
+std::vector<ManifestEntry> ChunkManifest::getEntries() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return entries;
+}
+
+ChunkFormat ChunkManifest::getChunkFormat() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return chunkFormat;
+}
+
+bool ChunkManifest::isAggregated() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return aggregated;
+}
+
+bool ChunkManifest::isSealed() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return sealed;
+}
+
+bool ChunkManifest::isMerged() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return merged;
+}
+
+std::string ChunkManifest::getMergedOutput() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return mergedOutput;
+}
+
+bool ChunkManifest::fileChecksum(const std::string& filename, uint64_t& bytes, uint32_t& checksum) {
+    std::FILE* in = std::fopen(filename.c_str(), "rb");
+    if (in == nullptr) return false;
+
+    std::vector<unsigned char> buffer(1 << 20);
+    uint32_t crc = 0xFFFFFFFFu;
+    bytes = 0;
+    size_t n;
+    while ((n = std::fread(buffer.data(), 1, buffer.size(), in)) > 0) {
+        crc = crc32Update(crc, buffer.data(), n);
+        bytes += n;
+    }
+    bool ok = !std::ferror(in);
+    std::fclose(in);
+
+    checksum = crc ^ 0xFFFFFFFFu;
+    return ok;
+}
+
+ChunkManifest::~ChunkManifest() {
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+}
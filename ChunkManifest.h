@@ -0,0 +1,192 @@
+/**
+ * @file ChunkManifest.h
+ * @brief Registro persistente de los chunks completos de la Fase 1
+ * @details Archivo de texto de solo anexado: cada chunk terminado agrega una línea con su
+ *          número, registros, bytes y CRC-32, y el archivo se sincroniza con fsync antes
+ *          de seguir. Si el proceso muere (o se presiona Q) los chunks registrados se
+ *          pueden validar y reutilizar con --resume sin repetir la captura.
+ *
+ * Formato:
+ *   esort-manifest 1 format=<text|binary|delta> aggregate=<0|1>
+ *   chunk <número> <registros> <bytes> <crc32 hex> <archivo>
+ *   sealed                          (la Fase 1 terminó: la fuente se agotó)
+ *   merged <registros> <archivo>    (la Fase 2 terminó)
+ */
+
+#ifndef CHUNKMANIFEST_H
+#define CHUNKMANIFEST_H
+
+#include "ChunkFile.h"
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ManifestEntry
+ * @brief Chunk registrado en el manifiesto
+ */
+struct ManifestEntry {
+    int index;              ///< Número del chunk (chunk_0<index>.tmp)
+    uint64_t records;       ///< Registros del chunk
+    uint64_t bytes;         ///< Tamaño del archivo en bytes
+    uint32_t checksum;      ///< CRC-32 del archivo completo
+    std::string filename;   ///< Nombre del archivo
+
+    ManifestEntry() : index(0), records(0), bytes(0), checksum(0) {}
+};
+
+/**
+ * @class ChunkManifest
+ * @brief Manifiesto de chunks con escrituras durables
+ * @details addChunk() puede llamarse desde varios hilos (los trabajadores del
+ *          ChunkPipeline). Cada línea se escribe solo después de sincronizar el chunk,
+ *          así una línea presente implica un chunk completo en disco; una línea final
+ *          cortada por una caída se ignora al cargar.
+ */
+class ChunkManifest {
+private:
+    std::string path;                   ///< Ruta del manifiesto
+    std::FILE* file;                    ///< Manifiesto abierto para anexar
+    mutable std::mutex mtx;             ///< Protege file y entries
+    std::vector<ManifestEntry> entries; ///< Chunks registrados
+    bool sealed;                        ///< La Fase 1 terminó
+    bool merged;                        ///< La Fase 2 terminó
+    ChunkFormat chunkFormat;            ///< Formato de los chunks registrados
+    bool aggregated;                    ///< Los chunks son pares (valor, repeticiones)
+    std::string mergedOutput;           ///< Archivo final de la Fase 2
+
+    ChunkManifest(const ChunkManifest&);            ///< No copiable
+    ChunkManifest& operator=(const ChunkManifest&); ///< No asignable
+
+    /**
+     * @brief Anexa una línea y la sincroniza en disco (requiere mtx)
+     * @param line Línea sin '\n'
+     * @return false si la escritura o el fsync fallaron
+     */
+    bool appendLine(const std::string& line);
+
+public:
+    /**
+     * @brief Constructor
+     * @param manifestPath Ruta del manifiesto (ej: "esort.manifest")
+     */
+    ChunkManifest(const std::string& manifestPath);
+
+    /**
+     * @brief Crea un manifiesto vacío (trunca el anterior) para un trabajo nuevo
+     * @param format Formato de los chunks del trabajo
+     * @param aggregate true si los chunks son pares (valor, repeticiones)
+     * @return false si no se pudo crear
+     * @details Ambos datos quedan en la cabecera: --resume los compara con sus opciones
+     *          para no mezclar chunks que no se pueden fusionar juntos
+     */
+    bool create(ChunkFormat format, bool aggregate);
+
+    /**
+     * @brief Carga un manifiesto existente y lo abre para seguir anexando
+     * @return false si no existe o no tiene la cabecera esperada
+     */
+    bool load();
+
+    /**
+     * @brief Formato de los chunks registrado en la cabecera
+     * @return Formato dado a create()
+     */
+    ChunkFormat getChunkFormat() const;
+
+    /**
+     * @brief Indica si los chunks registrados son pares (valor, repeticiones)
+     * @return aggregate dado a create()
+     */
+    bool isAggregated() const;
+
+    /**
+     * @brief Registra un chunk ya escrito
+     * @param index Número del chunk
+     * @param filename Archivo del chunk
+     * @param records Registros que contiene
+     * @return false si no se pudo leer el chunk o escribir el manifiesto
+     * @details Sincroniza el chunk y su directorio, calcula su CRC-32 y luego anexa la
+     *          línea; el costo recae en el hilo que escribió el chunk
+     */
+    bool addChunk(int index, const std::string& filename, uint64_t records);
+
+    /**
+     * @brief Marca la Fase 1 como terminada (la fuente se agotó)
+     * @return false si no se pudo escribir
+     */
+    bool seal();
+
+    /**
+     * @brief Marca la Fase 2 como terminada
+     * @param outputFile Archivo final
+     * @param records Registros del archivo final
+     * @return false si no se pudo escribir
+     */
+    bool markMerged(const std::string& outputFile, uint64_t records);
+
+    /**
+     * @brief Valida los chunks registrados contra los archivos en disco
+     * @param valid Chunks válidos ordenados por número
+     * @param validRecords Registros de los chunks válidos
+     * @return false si algún chunk falta o no coincide (sus datos se perderían)
+     * @details Un chunk es válido si existe, su tamaño y CRC-32 coinciden y, en binario,
+     *          el encabezado tiene el número de registros esperado; cada inválido se
+     *          informa por std::cerr y queda fuera de valid
+     */
+    bool validate(std::vector<std::string>& valid, uint64_t& validRecords) const;
+
+    /**
+     * @brief Número para el siguiente chunk
+     * @return Mayor número registrado + 1 (1 si no hay chunks)
+     */
+    int nextIndex() const;
+
+    /**
+     * @brief Registros en los chunks registrados
+     * @return Suma de registros
+     */
+    uint64_t totalRecords() const;
+
+    /**
+     * @brief Chunks registrados
+     * @return Copia de las entradas
+     */
+    std::vector<ManifestEntry> getEntries() const;
+
+    /**
+     * @brief Indica si la Fase 1 terminó
+     * @return true si el manifiesto está sellado
+     */
+    bool isSealed() const;
+
+    /**
+     * @brief Indica si la Fase 2 terminó
+     * @return true si hay una línea merged
+     */
+    bool isMerged() const;
+
+    /**
+     * @brief Archivo final registrado por markMerged()
+     * @return Nombre del archivo (vacío si no se fusionó)
+     */
+    std::string getMergedOutput() const;
+
+    /**
+     * @brief Calcula tamaño y CRC-32 de un archivo
+     * @param filename Archivo a leer
+     * @param bytes Tamaño en bytes
+     * @param checksum CRC-32 (IEEE 802.3) del contenido
+     * @return false si no se pudo leer
+     */
+    static bool fileChecksum(const std::string& filename, uint64_t& bytes, uint32_t& checksum);
+
+    /**
+     * @brief Destructor que cierra el manifiesto
+     */
+    ~ChunkManifest();
+};
+
+#endif
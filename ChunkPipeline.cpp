@@ -0,0 +1,275 @@
+/**
+ * @file ChunkPipeline.cpp
+ * @brief Implementación de ChunkPipeline
+ */
+
+#include "ChunkPipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+const int PREVIEW_RECORDS = 8;         ///< Datos que se muestran de cada chunk escrito
+const uint32_t CHUNK_LOG_PER_SECOND = 10; ///< Mensajes de chunk por segundo (nivel DEBUG)
+
+/**
+ * @brief Colapsa las repeticiones contiguas de un arreglo ordenado en pares
+ * @param data Datos ordenados
+ * @param count Número de datos
+ * @param pairs Destino con espacio para count pares
+ * @return Número de pares (valores distintos)
+ */
+int collapseRuns(const int* data, int count, CountedValue* pairs) {
+    int pairCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (pairCount > 0 && pairs[pairCount - 1].value == data[i]) {
+            pairs[pairCount - 1].count++;
+        } else {
+            pairs[pairCount++] = CountedValue(data[i], 1);
+        }
+    }
+    return pairCount;
+}
+
+} // namespace
+
+ChunkPipeline::ChunkPipeline(int size, ChunkFormat format, int workerCount,
+                             int buffersPerWorker, const std::string& prefix, int startIndex)
+    : bufferSize(size), chunkFormat(format), chunkPrefix(prefix), nextChunk(startIndex),
+      nextWorker(0), acquiredFrom(0), finishing(false), writeFailed(false), metrics(nullptr),
+      manifest(nullptr), liveIndex(nullptr), aggregate(false),
+      chunkLog(CHUNK_LOG_PER_SECOND, 1000) {
+    int count = workerCount < 1 ? 1 : workerCount;
+    int perWorker = buffersPerWorker < 2 ? 2 : buffersPerWorker;
+
+    for (int w = 0; w < count; w++) {
+        Worker* worker = new Worker(perWorker);
+        for (int i = 0; i < perWorker; i++) {
+            buffers.push_back(new CircularBuffer(bufferSize, SortEngine::RADIX));
+            worker->empty.tryPush(ChunkJob(buffers.back(), 0));
+        }
+        workers.push_back(worker);
+    }
+
+    for (size_t w = 0; w < workers.size(); w++) {
+        workers[w]->thread = std::thread(&ChunkPipeline::workerLoop, this, workers[w]);
+    }
+}
+
+int ChunkPipeline::chooseBufferSize(size_t memoryBudget, int workerCount, int buffersPerWorker,
+                                    bool aggregated) {
+    size_t workers = workerCount < 1 ? 1 : static_cast<size_t>(workerCount);
+    size_t perWorker = buffersPerWorker < 2 ? 2 : static_cast<size_t>(buffersPerWorker);
+
+    size_t writerBytes = workers * 2 * BlockWriter::DEFAULT_BLOCK_SIZE;
+    size_t available = memoryBudget > writerBytes ? memoryBudget - writerBytes : 0;
+    size_t perRecord = workers * perWorker * CircularBuffer::bytesPerRecord() +
+                       (aggregated ? workers * sizeof(CountedValue) : 0);
+    size_t records = available / perRecord;
+
+    const size_t MAX_RECORDS = static_cast<size_t>(std::numeric_limits<int>::max());
+    if (records > MAX_RECORDS) records = MAX_RECORDS;
+    return records < 1 ? 1 : static_cast<int>(records);
+}
+
+CircularBuffer* ChunkPipeline::acquire() {
+    ChunkJob job;
+    int spins = 0;
+    while (true) {
+        for (size_t i = 0; i < workers.size(); i++) {
+            size_t w = (nextWorker + i) % workers.size();
+            if (workers[w]->empty.tryPop(job)) {
+                acquiredFrom = w;
+                nextWorker = (w + 1) % workers.size();
+                return job.buffer;
+            }
+        }
+        backoff(spins);
+    }
+}
+
+void ChunkPipeline::submit(CircularBuffer* buffer) {
+    // El buffer vuelve al trabajador que lo prestó; siempre hay lugar en su cola
+    ChunkJob job(buffer, nextChunk++);
+    if (liveIndex != nullptr) {
+        liveIndex->addPending(static_cast<uint64_t>(buffer->size()));
+    }
+    Worker* worker = workers[acquiredFrom];
+    int spins = 0;
+    while (!worker->filled.tryPush(job)) {
+        backoff(spins);
+    }
+    // Tomar el mutex entre el push y el aviso: el trabajador no puede perderlo
+    { std::lock_guard<std::mutex> lock(worker->mtx); }
+    worker->wake.notify_one();
+}
+
+bool ChunkPipeline::spill(Worker& worker, CircularBuffer& buffer, const std::string& filename,
+                          uint64_t& written) {
+    auto sortStart = std::chrono::steady_clock::now();
+    // Los datos ordenados se escriben desde el arreglo del buffer, sin copia por chunk
+    int count = buffer.size();
+    const int* data = buffer.sortedData();
+
+    auto spillStart = std::chrono::steady_clock::now();
+    bool ok;
+    written = static_cast<uint64_t>(count);
+    if (aggregate) {
+        if (worker.pairs.size() < static_cast<size_t>(count)) {
+            worker.pairs.resize(static_cast<size_t>(bufferSize));
+        }
+        int pairCount = collapseRuns(data, count, worker.pairs.data());
+        ok = writeChunk<CountedValue, CountedValueKey>(filename, worker.pairs.data(), pairCount,
+                                                        chunkFormat);
+        written = static_cast<uint64_t>(pairCount);
+    } else {
+        ok = writeChunk(filename, data, count, chunkFormat);
+    }
+    auto spillEnd = std::chrono::steady_clock::now();
+
+    if (liveIndex != nullptr) {
+        if (ok) liveIndex->chunkWritten(LiveChunk(filename, count, data[0], data[count - 1]));
+        else liveIndex->chunkFailed(count);
+    }
+    if (ok && metrics != nullptr) {
+        metrics->recordChunk(count, std::chrono::duration<double>(spillStart - sortStart).count(),
+                             std::chrono::duration<double>(spillEnd - spillStart).count());
+    }
+    Logger& log = Logger::instance();
+    if (!ok) {
+        // Cada fallo se informa: esos datos ya se leyeron y no llegan a la Fase 2
+        log.write(LogLevel::ERR, "No se pudo escribir " + filename + "; se pierden " +
+                                     std::to_string(count) + " datos");
+        return false;
+    }
+
+    // Con buffers chicos hay un chunk cada pocas lecturas: nivel DEBUG y con límite
+    uint64_t skipped = 0;
+    if (log.enabled(LogLevel::DEBUG) && chunkLog.allow(skipped)) {
+        std::ostringstream message;
+        message << "Escribiendo " << filename << ": [";
+        if (count <= PREVIEW_RECORDS) {
+            for (int i = 0; i < count; i++) {
+                message << data[i];
+                if (i < count - 1) message << ", ";
+            }
+            message << "]";
+        } else {
+            // Buffers grandes (--mem): solo el inicio y el final
+            for (int i = 0; i < PREVIEW_RECORDS - 1; i++) {
+                message << data[i] << ", ";
+            }
+            message << "..., " << data[count - 1] << "] (" << count << " datos)";
+        }
+        if (aggregate) {
+            message << " -> " << written << " pares (valor, repeticiones)";
+        }
+        if (skipped > 0) {
+            message << " (" << skipped << " chunks sin informar)";
+        }
+        log.write(LogLevel::DEBUG, message.str());
+    }
+
+    return true;
+}
+
+void ChunkPipeline::workerLoop(Worker* worker) {
+    while (true) {
+        ChunkJob job;
+        if (!worker->filled.tryPop(job)) {
+            // Ocioso: espera bloqueado a que submit() o finish() lo despierten
+            std::unique_lock<std::mutex> lock(worker->mtx);
+            worker->wake.wait(lock, [&] {
+                return !worker->filled.empty() || finishing.load(std::memory_order_acquire);
+            });
+            if (worker->filled.empty()) {
+                break;
+            }
+            continue;
+        }
+
+        if (!job.buffer->isEmpty()) {
+            std::string filename = chunkPrefix + std::to_string(job.index) + ".tmp";
+            uint64_t written = 0;
+            if (spill(*worker, *job.buffer, filename, written)) {
+                // Un chunk fuera del manifiesto se perdería en un --resume: cuenta como fallo
+                if (manifest != nullptr && !manifest->addChunk(job.index, filename, written)) {
+                    writeFailed.store(true, std::memory_order_release);
+                }
+                worker->written.push_back(std::make_pair(job.index, filename));
+            } else {
+                writeFailed.store(true, std::memory_order_release);
+            }
+        }
+
+        job.buffer->clear();
+
+        int pushSpins = 0;
+        while (!worker->empty.tryPush(job)) {
+            backoff(pushSpins);
+        }
+    }
+}
+
+std::vector<std::string> ChunkPipeline::finish() {
+    if (finishing.load()) {
+        return chunkFiles;
+    }
+
+    finishing.store(true, std::memory_order_release);
+    for (size_t w = 0; w < workers.size(); w++) {
+        { std::lock_guard<std::mutex> lock(workers[w]->mtx); }
+        workers[w]->wake.notify_one();
+    }
+
+    std::vector<std::pair<int, std::string> > all;
+    for (size_t w = 0; w < workers.size(); w++) {
+        if (workers[w]->thread.joinable()) {
+            workers[w]->thread.join();
+        }
+        all.insert(all.end(), workers[w]->written.begin(), workers[w]->written.end());
+    }
+
+    std::sort(all.begin(), all.end());
+    chunkFiles.clear();
+    for (size_t i = 0; i < all.size(); i++) {
+        chunkFiles.push_back(all[i].second);
+    }
+    return chunkFiles;
+}
+
+bool ChunkPipeline::hasWriteFailed() const {
+    return writeFailed.load(std::memory_order_acquire);
+}
+
+void ChunkPipeline::setMetrics(RunMetrics* runMetrics) {
+    metrics = runMetrics;
+}
+
+void ChunkPipeline::setManifest(ChunkManifest* chunkManifest) {
+    manifest = chunkManifest;
+}
+
+void ChunkPipeline::setLiveIndex(LiveIndex* index) {
+    liveIndex = index;
+}
+
+void ChunkPipeline::setAggregate(bool enabled) {
+    aggregate = enabled;
+}
+
+int ChunkPipeline::getWorkerCount() const {
+    return static_cast<int>(workers.size());
+}
+
+ChunkPipeline::~ChunkPipeline() {
+    finish();
+    for (size_t w = 0; w < workers.size(); w++) {
+        delete workers[w];
+    }
+    for (size_t i = 0; i < buffers.size(); i++) {
+        delete buffers[i];
+    }
+}
@@ -0,0 +1,204 @@
+/**
+ * @file ChunkPipeline.h
+ * @brief Canal productor/consumidor entre la adquisición y el ordenamiento de chunks
+ * @details El hilo de adquisición llena un buffer mientras un grupo fijo de hilos
+ *          trabajadores ordena y escribe en disco los buffers anteriores
+ */
+
+#ifndef CHUNKPIPELINE_H
+#define CHUNKPIPELINE_H
+
+#include "CircularBuffer.h"
+#include "ChunkFile.h"
+#include "ChunkManifest.h"
+#include "LiveQuery.h"
+#include "Logger.h"
+#include "RunMetrics.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct ChunkJob
+ * @brief Buffer en tránsito entre la adquisición y un trabajador
+ */
+struct ChunkJob {
+    CircularBuffer* buffer; ///< Buffer lleno (o vacío, de regreso a la adquisición)
+    int index;              ///< Número de chunk asignado al entregarlo
+
+    ChunkJob() : buffer(nullptr), index(0) {}
+    ChunkJob(CircularBuffer* b, int i) : buffer(b), index(i) {}
+};
+
+/**
+ * @class ChunkPipeline
+ * @brief Rota conjuntos fijos de CircularBuffer entre la adquisición y un pool de trabajadores
+ * @details Cada trabajador tiene sus propios buffers y dos SpscQueue: "filled" lleva
+ *          buffers llenos al trabajador y "empty" los devuelve limpios. La adquisición
+ *          toma el primer buffer libre en orden round-robin, así que solo espera si todos
+ *          los buffers de todos los trabajadores están pendientes. El número de chunk se
+ *          asigna al entregar el buffer, por lo que nombres y orden de los chunks son
+ *          deterministas sin importar qué trabajador termine primero.
+ */
+class ChunkPipeline {
+private:
+    /**
+     * @struct Worker
+     * @brief Estado de un hilo trabajador del pool
+     */
+    struct Worker {
+        SpscQueue<ChunkJob> filled;     ///< Buffers llenos pendientes de ordenar
+        SpscQueue<ChunkJob> empty;      ///< Buffers libres para la adquisición
+        std::vector<std::pair<int, std::string> > written; ///< (índice, chunk) escritos
+        std::vector<CountedValue> pairs; ///< Pares del chunk en curso (solo con setAggregate())
+        std::thread thread;             ///< Hilo que ordena y escribe
+        std::mutex mtx;                 ///< Acompaña a wake (filled es sin bloqueos)
+        std::condition_variable wake;   ///< Despierta al trabajador ocioso (submit o finish)
+
+        Worker(size_t slots) : filled(slots), empty(slots) {}
+    };
+
+    int bufferSize;                        ///< Capacidad de cada CircularBuffer
+    ChunkFormat chunkFormat;               ///< Formato de los chunks escritos
+    std::string chunkPrefix;               ///< Prefijo de los nombres de chunk
+    int nextChunk;                         ///< Número del siguiente chunk a entregar
+    std::vector<CircularBuffer*> buffers;  ///< Buffers propiedad del pipeline
+    std::vector<Worker*> workers;          ///< Pool fijo de trabajadores
+    size_t nextWorker;                     ///< Trabajador donde empieza la búsqueda round-robin
+    size_t acquiredFrom;                   ///< Trabajador dueño del último buffer adquirido
+    std::vector<std::string> chunkFiles;   ///< Chunks escritos, en orden de entrega
+    std::atomic<bool> finishing;           ///< Solicita a los trabajadores terminar al vaciar su cola
+    std::atomic<bool> writeFailed;         ///< Algún chunk no se pudo escribir (no se reinicia)
+    RunMetrics* metrics;                   ///< Destino de los tiempos por chunk (opcional)
+    ChunkManifest* manifest;               ///< Registro durable de chunks escritos (opcional)
+    LiveIndex* liveIndex;                  ///< Índice de consultas en vivo (opcional)
+    bool aggregate;                        ///< Escribir pares (valor, repeticiones)
+    LogRateLimit chunkLog;                 ///< Límite de los mensajes por chunk escrito
+
+    ChunkPipeline(const ChunkPipeline&);            ///< No copiable
+    ChunkPipeline& operator=(const ChunkPipeline&); ///< No asignable
+
+    /**
+     * @brief Bucle de un hilo trabajador
+     * @param worker Trabajador que ejecuta el bucle
+     */
+    void workerLoop(Worker* worker);
+
+    /**
+     * @brief Ordena un buffer y lo escribe como chunk
+     * @param worker Trabajador que escribe (aporta el arreglo de pares)
+     * @param buffer Buffer lleno
+     * @param filename Nombre del chunk a escribir
+     * @param written Registros del chunk (pares si se agrega)
+     * @return true si el chunk se escribió correctamente
+     */
+    bool spill(Worker& worker, CircularBuffer& buffer, const std::string& filename,
+               uint64_t& written);
+
+public:
+    /**
+     * @brief Constructor que reserva los buffers y arranca el pool de trabajadores
+     * @param size Capacidad de cada buffer
+     * @param format Formato de los chunks
+     * @param workerCount Número de hilos trabajadores (mínimo 1)
+     * @param buffersPerWorker Buffers en rotación por trabajador (mínimo 2)
+     * @param prefix Prefijo de los chunks ("chunk_0" produce chunk_01.tmp, chunk_02.tmp...)
+     * @param startIndex Número del primer chunk
+     * @details La memoria usada es workerCount * buffersPerWorker * size datos
+     */
+    ChunkPipeline(int size, ChunkFormat format, int workerCount = 1, int buffersPerWorker = 2,
+                  const std::string& prefix = "chunk_0", int startIndex = 1);
+
+    /**
+     * @brief Calcula la capacidad de cada buffer a partir de un presupuesto de memoria
+     * @param memoryBudget Bytes disponibles para la Fase 1
+     * @param workerCount Hilos trabajadores
+     * @param buffersPerWorker Buffers en rotación por trabajador
+     * @param aggregated true si los chunks se escriben como pares (ver setAggregate())
+     * @return Registros por buffer (al menos 1)
+     * @details Reparte el presupuesto entre todos los buffers en rotación después de
+     *          reservar los bloques del BlockWriter de cada trabajador; cada registro
+     *          cuesta CircularBuffer::bytesPerRecord() (más el par de peor caso, todos
+     *          distintos, si se agrega)
+     */
+    static int chooseBufferSize(size_t memoryBudget, int workerCount, int buffersPerWorker = 2,
+                                bool aggregated = false);
+
+    /**
+     * @brief Obtiene un buffer vacío para llenar
+     * @return Buffer vacío
+     * @details Solo espera si todos los buffers están en cola para ordenarse
+     */
+    CircularBuffer* acquire();
+
+    /**
+     * @brief Entrega el último buffer adquirido para que se ordene y escriba
+     * @param buffer Buffer obtenido con acquire()
+     */
+    void submit(CircularBuffer* buffer);
+
+    /**
+     * @brief Espera a que se escriban todos los buffers entregados
+     * @return Nombres de los chunks escritos, en el orden en que se entregaron
+     */
+    std::vector<std::string> finish();
+
+    /**
+     * @brief Indica si algún chunk entregado no se pudo escribir
+     * @return true si quedaron datos leídos sin guardar (cualquier hilo)
+     * @details La adquisición lo consulta entre lotes para dejar de leer: seguir
+     *          capturando solo perdería más datos
+     */
+    bool hasWriteFailed() const;
+
+    /**
+     * @brief Registra los tiempos de ordenamiento y escritura de cada chunk
+     * @param runMetrics Métricas de la ejecución (nullptr para no registrar)
+     * @details Llamar antes del primer submit()
+     */
+    void setMetrics(RunMetrics* runMetrics);
+
+    /**
+     * @brief Registra cada chunk escrito en un manifiesto durable
+     * @param chunkManifest Manifiesto (nullptr para no registrar)
+     * @details El trabajador sincroniza el chunk y anexa su línea antes de devolver el
+     *          buffer. Si el registro falla se trata como un chunk no escrito (ver
+     *          hasWriteFailed()). Llamar antes del primer submit()
+     */
+    void setManifest(ChunkManifest* chunkManifest);
+
+    /**
+     * @brief Publica cada buffer entregado y cada chunk escrito para las consultas en vivo
+     * @param index Índice de consultas (nullptr para no publicar)
+     * @details Solo para chunks de enteros (sin setAggregate()). Llamar antes del
+     *          primer submit()
+     */
+    void setLiveIndex(LiveIndex* index);
+
+    /**
+     * @brief Colapsa cada buffer ordenado en pares (valor, repeticiones) antes de escribirlo
+     * @param enabled true para escribir chunks de CountedValue
+     * @details Las repeticiones de un valor quedan contiguas al ordenar, así que el
+     *          colapso es una pasada lineal. Requiere datos por dato adicionales: ver
+     *          chooseBufferSize(). Llamar antes del primer submit()
+     */
+    void setAggregate(bool enabled);
+
+    /**
+     * @brief Obtiene el número de trabajadores del pool
+     * @return Hilos trabajadores
+     */
+    int getWorkerCount() const;
+
+    /**
+     * @brief Destructor que detiene los trabajadores y libera los buffers
+     */
+    ~ChunkPipeline();
+};
+
+#endif
@@ -1,58 +1,113 @@
 /**
  * @file CircularBuffer.h
  * @brief Lista circular doblemente enlazada de tamaño fijo
- * @details Implementa un buffer circular para almacenar temporalmente los datos entrantes
+ * @details Implementa un buffer circular para almacenar temporalmente los datos entrantes.
+ *          Es una plantilla sobre el tipo de registro; CircularBuffer es la instancia
+ *          para int, compilada una sola vez en CircularBuffer.cpp.
  */
 
 #ifndef CIRCULARBUFFER_H
 #define CIRCULARBUFFER_H
 
+#include "Record.h"
+#include "SortAlgorithms.h"
 #include <iostream>
+#include <type_traits>
 
 /**
- * @struct Node
+ * @struct BasicNode
  * @brief Nodo de la lista doblemente enlazada
- * @details Almacena un dato entero y punteros a nodos anterior y siguiente
+ * @details Almacena un registro y punteros a nodos anterior y siguiente
  */
-struct Node {
-    int data;      ///< Dato almacenado en el nodo
-    Node* next;    ///< Puntero al siguiente nodo
-    Node* prev;    ///< Puntero al nodo anterior
+template<typename T>
+struct BasicNode {
+    T data;            ///< Dato almacenado en el nodo
+    BasicNode* next;   ///< Puntero al siguiente nodo
+    BasicNode* prev;   ///< Puntero al nodo anterior
+
+    /**
+     * @brief Constructor por defecto usado al reservar el arena del buffer
+     */
+    BasicNode() : data(), next(nullptr), prev(nullptr) {}
 
     /**
      * @brief Constructor del nodo
      * @param value Valor a almacenar
      */
-    Node(int value) : data(value), next(nullptr), prev(nullptr) {}
+    BasicNode(const T& value) : data(value), next(nullptr), prev(nullptr) {}
 };
 
+typedef BasicNode<int> Node;  ///< Nodo de enteros
+
 /**
- * @class CircularBuffer
+ * @class BasicCircularBuffer
  * @brief Buffer circular de tamaño fijo implementado con lista doblemente enlazada
- * @details Maneja la inserción y ordenamiento de datos en memoria fija
+ * @details Maneja la inserción y ordenamiento de datos en memoria fija.
+ *          Los nodos se toman de un arena contiguo reservado una sola vez en el
+ *          constructor, por lo que insert() y clear() no llaman a new/delete.
+ *          T es el registro, KeyOf extrae su clave y Compare define el orden; el motor
+ *          RADIX solo se usa con el comparador por defecto y clave entera (si no, se
+ *          ordena con INTRO).
  */
-class CircularBuffer {
+template<typename T, typename KeyOf = IdentityKey<T>, typename Compare = KeyLess<KeyOf> >
+class BasicCircularBuffer {
 private:
-    Node* head;           ///< Puntero al primer nodo
-    Node* tail;           ///< Puntero al último nodo
+    typedef BasicNode<T> NodeType;
+
+    /// Radix ordena por los bytes de la clave: solo coincide con Compare si es KeyLess<KeyOf>
+    typedef std::integral_constant<bool,
+        std::is_same<Compare, KeyLess<KeyOf> >::value &&
+        std::is_integral<typename KeyOf::KeyType>::value> RadixUsable;
+
+    NodeType* arena;      ///< Bloque contiguo de nodos reservado con capacidad fija
+    NodeType* head;       ///< Puntero al primer nodo
+    NodeType* tail;       ///< Puntero al último nodo
     int capacity;         ///< Capacidad máxima del buffer
     int currentSize;      ///< Tamaño actual del buffer
+    SortEngine engine;    ///< Motor usado por sort()
+    T* scratch;           ///< Arreglo contiguo donde se ordenan los datos (capacity)
+    T* aux;               ///< Arreglo auxiliar para Radix/Merge Sort (capacity)
+    Compare less;         ///< Comparador de registros
+
+    /**
+     * @brief Insertion Sort original intercambiando valores sobre la lista
+     */
+    void sortInPlaceList();
+
+    /**
+     * @brief Ordena scratch con Radix Sort
+     */
+    void radixOrIntro(std::true_type) {
+        radixSort<KeyOf>(scratch, currentSize, aux);
+    }
+
+    /**
+     * @brief Comparador propio o clave no entera: Radix no aplica, se usa Introsort
+     */
+    void radixOrIntro(std::false_type) {
+        introSort(scratch, currentSize, less);
+    }
+
+    BasicCircularBuffer(const BasicCircularBuffer&);            ///< No copiable (posee el arena)
+    BasicCircularBuffer& operator=(const BasicCircularBuffer&); ///< No asignable (posee el arena)
 
 public:
     /**
      * @brief Constructor que inicializa el buffer
      * @param size Tamaño fijo del buffer (ej: 1000 elementos)
-     * @details Crea un buffer vacío con capacidad especificada
+     * @param sortEngine Motor de ordenamiento a usar en sort() (por defecto Radix Sort)
+     * @details Crea un buffer vacío y reserva el arena de nodos de una sola vez
      */
-    CircularBuffer(int size);
+    BasicCircularBuffer(int size, SortEngine sortEngine = SortEngine::RADIX);
 
     /**
      * @brief Inserta un dato en el buffer
      * @param value Valor a insertar
-     * @details Si el buffer está lleno, retorna false; si no, inserta al final
+     * @details Si el buffer está lleno, retorna false; si no, enlaza al final
+     *          el siguiente nodo libre del arena
      * @return true si se insertó, false si el buffer está lleno
      */
-    bool insert(int value);
+    bool insert(const T& value);
 
     /**
      * @brief Verifica si el buffer está lleno
@@ -73,22 +128,51 @@ public:
     int size() const;
 
     /**
-     * @brief Ordena el contenido del buffer usando Insertion Sort
-     * @details Ordena los datos de menor a mayor in-place
+     * @brief Memoria reservada por cada registro de capacidad
+     * @return Bytes por registro: nodo del arena más los arreglos scratch y aux
+     */
+    static size_t bytesPerRecord() {
+        return sizeof(NodeType) + 2 * sizeof(T);
+    }
+
+    /**
+     * @brief Ordena el contenido del buffer con el motor seleccionado
+     * @details Ordena los datos de menor a mayor. Salvo INSERTION, copia los datos
+     *          a un arreglo contiguo, los ordena ahí y los reescribe sobre la lista
      */
     void sort();
 
+    /**
+     * @brief Cambia el motor de ordenamiento en tiempo de ejecución
+     * @param sortEngine Nuevo motor a usar en las siguientes llamadas a sort()
+     */
+    void setSortEngine(SortEngine sortEngine);
+
+    /**
+     * @brief Obtiene el motor de ordenamiento actual
+     * @return Motor usado por sort()
+     */
+    SortEngine getSortEngine() const;
+
     /**
      * @brief Obtiene todos los datos del buffer en un arreglo
      * @param arr Arreglo donde se copiarán los datos
      * @param arrSize Tamaño del arreglo (debe ser >= currentSize)
      * @details Copia los datos ordenados al arreglo proporcionado
      */
-    void getData(int* arr, int arrSize);
+    void getData(T* arr, int arrSize);
 
     /**
-     * @brief Limpia el buffer liberando toda la memoria
-     * @details Elimina todos los nodos y reinicia el buffer
+     * @brief Ordena el buffer y devuelve los datos ordenados sin copiarlos
+     * @return Arreglo interno con size() datos ordenados
+     * @details Es el arreglo donde sort() ya ordenó; sigue siendo válido hasta el
+     *          siguiente insert(), sort() o clear()
+     */
+    const T* sortedData();
+
+    /**
+     * @brief Limpia el buffer para reutilizarlo en el siguiente chunk
+     * @details Reinicia head/tail y el tamaño; el arena se conserva sin liberar memoria
      */
     void clear();
 
@@ -98,9 +182,181 @@ public:
     void print() const;
 
     /**
-     * @brief Destructor que libera toda la memoria
+     * @brief Destructor que libera el arena de nodos
      */
-    ~CircularBuffer();
+    ~BasicCircularBuffer();
 };
 
-#endif
\ No newline at end of file
+typedef BasicCircularBuffer<int> CircularBuffer;  ///< Buffer de enteros usado por la Fase 1
+
+template<typename T, typename KeyOf, typename Compare>
+BasicCircularBuffer<T, KeyOf, Compare>::BasicCircularBuffer(int size, SortEngine sortEngine)
+    : arena(nullptr), head(nullptr), tail(nullptr), capacity(size), currentSize(0),
+      engine(sortEngine), scratch(nullptr), aux(nullptr) {
+    if (capacity > 0) {
+        arena = new NodeType[capacity];
+        scratch = new T[capacity];
+        aux = new T[capacity];
+    }
+}
+
+template<typename T, typename KeyOf, typename Compare>
+bool BasicCircularBuffer<T, KeyOf, Compare>::insert(const T& value) {
+    if (isFull()) {
+        return false;
+    }
+
+    // Los nodos se consumen del arena en orden; clear() reinicia el índice
+    NodeType* newNode = &arena[currentSize];
+    newNode->data = value;
+
+    if (isEmpty()) {
+        head = tail = newNode;
+        newNode->next = newNode;
+        newNode->prev = newNode;
+    } else {
+        newNode->prev = tail;
+        newNode->next = head;
+        tail->next = newNode;
+        head->prev = newNode;
+        tail = newNode;
+    }
+
+    currentSize++;
+    return true;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+bool BasicCircularBuffer<T, KeyOf, Compare>::isFull() const {
+    return currentSize >= capacity;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+bool BasicCircularBuffer<T, KeyOf, Compare>::isEmpty() const {
+    return currentSize == 0;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+int BasicCircularBuffer<T, KeyOf, Compare>::size() const {
+    return currentSize;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicCircularBuffer<T, KeyOf, Compare>::sort() {
+    if (currentSize <= 1) return;
+
+    if (engine == SortEngine::INSERTION) {
+        sortInPlaceList();
+        return;
+    }
+
+    getData(scratch, currentSize);
+
+    switch (engine) {
+        case SortEngine::RADIX: radixOrIntro(RadixUsable()); break;
+        case SortEngine::INTRO: introSort(scratch, currentSize, less); break;
+        case SortEngine::MERGE: mergeSort(scratch, currentSize, aux, less); break;
+        default:                insertionSort(scratch, currentSize, less); break;
+    }
+
+    NodeType* current = head;
+    for (int i = 0; i < currentSize; i++) {
+        current->data = scratch[i];
+        current = current->next;
+    }
+}
+
+template<typename T, typename KeyOf, typename Compare>
+const T* BasicCircularBuffer<T, KeyOf, Compare>::sortedData() {
+    sort();
+    // INSERTION y los buffers de un dato ordenan sobre la lista, no en scratch
+    if (engine == SortEngine::INSERTION || currentSize <= 1) {
+        getData(scratch, currentSize);
+    }
+    return scratch;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicCircularBuffer<T, KeyOf, Compare>::setSortEngine(SortEngine sortEngine) {
+    engine = sortEngine;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+SortEngine BasicCircularBuffer<T, KeyOf, Compare>::getSortEngine() const {
+    return engine;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicCircularBuffer<T, KeyOf, Compare>::sortInPlaceList() {
+    NodeType* current = head->next;
+    int count = 1;
+
+    while (count < currentSize) {
+        NodeType* key = current;
+        T keyData = key->data;
+        NodeType* prev = key->prev;
+
+        while (prev != tail && less(keyData, prev->data)) {
+            prev->next->data = prev->data;
+            prev = prev->prev;
+        }
+
+        if (prev == tail && less(keyData, prev->data)) {
+            prev->next->data = prev->data;
+            head->data = keyData;
+        } else {
+            prev->next->data = keyData;
+        }
+
+        current = current->next;
+        count++;
+    }
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicCircularBuffer<T, KeyOf, Compare>::getData(T* arr, int arrSize) {
+    if (isEmpty() || arrSize < currentSize) return;
+
+    NodeType* current = head;
+    for (int i = 0; i < currentSize; i++) {
+        arr[i] = current->data;
+        current = current->next;
+    }
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicCircularBuffer<T, KeyOf, Compare>::clear() {
+    head = tail = nullptr;
+    currentSize = 0;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicCircularBuffer<T, KeyOf, Compare>::print() const {
+    if (isEmpty()) {
+        std::cout << "Buffer vacío" << std::endl;
+        return;
+    }
+
+    NodeType* current = head;
+    std::cout << "[";
+    for (int i = 0; i < currentSize; i++) {
+        std::cout << current->data;
+        if (i < currentSize - 1) std::cout << ", ";
+        current = current->next;
+    }
+    std::cout << "]" << std::endl;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+BasicCircularBuffer<T, KeyOf, Compare>::~BasicCircularBuffer() {
+    clear();
+    delete[] arena;
+    delete[] scratch;
+    delete[] aux;
+}
+
+// Instancias compiladas en CircularBuffer.cpp
+extern template class BasicCircularBuffer<int>;
+extern template class BasicCircularBuffer<TelemetryRecord, TimestampKey>;
+
+#endif
@@ -7,19 +7,48 @@
 #ifndef DATASOURCE_H
 #define DATASOURCE_H
 
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum ReadStatus
+ * @brief Estado de una fuente después de una lectura por lotes
+ */
+enum class ReadStatus {
+    OK,          ///< Puede haber más datos
+    END_OF_DATA, ///< La fuente terminó normalmente (fin de archivo, timeout o desconexión)
+    IO_ERROR     ///< La fuente no pudo abrirse o sus datos están dañados/truncados
+};
+
+/**
+ * @struct SourceStats
+ * @brief Contadores de ingesta de una fuente, para las métricas de la ejecución
+ */
+struct SourceStats {
+    uint64_t records;        ///< Lecturas válidas entregadas
+    uint64_t bytes;          ///< Bytes recibidos del dispositivo o archivo
+    uint64_t timeouts;       ///< Timeouts de lectura
+    uint64_t invalidLines;   ///< Líneas de texto descartadas
+    uint64_t corruptFrames;  ///< Tramas binarias descartadas
+
+    SourceStats() : records(0), bytes(0), timeouts(0), invalidLines(0), corruptFrames(0) {}
+};
+
 /**
- * @class DataSource
+ * @class BasicDataSource
  * @brief Clase base abstracta para abstracción de fuentes de datos
- * @details Proporciona una interfaz común para leer datos desde diferentes orígenes
+ * @details Proporciona una interfaz común para leer registros de tipo T desde
+ *          diferentes orígenes; DataSource es la fuente de enteros
  */
-class DataSource {
+template<typename T>
+class BasicDataSource {
 public:
     /**
-     * @brief Obtiene el siguiente dato entero de la fuente
-     * @return int El siguiente valor entero leído
+     * @brief Obtiene el siguiente dato de la fuente
+     * @return El siguiente registro leído
      * @details Método virtual puro que debe ser implementado por clases derivadas
      */
-    virtual int getNext() = 0;
+    virtual T getNext() = 0;
 
     /**
      * @brief Verifica si hay más datos disponibles
@@ -28,11 +57,52 @@ public:
      */
     virtual bool hasMoreData() = 0;
 
+    /**
+     * @brief Lee un lote de datos de la fuente
+     * @param out Arreglo destino
+     * @param max Capacidad de out
+     * @return Datos escritos en out; 0 solo cuando la fuente terminó (ver getStatus())
+     * @details Evita una llamada virtual y una comprobación de fin por dato. Las fuentes
+     *          en vivo esperan hasta tener al menos un dato y luego devuelven lo que ya
+     *          esté disponible sin volver a esperar.
+     */
+    virtual size_t read(T* out, size_t max) = 0;
+
+    /**
+     * @brief Indica si la fuente sigue activa, terminó o falló
+     * @return OK mientras haya datos; END_OF_DATA o IO_ERROR cuando read() devuelve 0
+     * @details A diferencia de getNext(), que devuelve T() al terminar, distingue el fin
+     *          de los datos de una lectura real igual a 0
+     */
+    virtual ReadStatus getStatus() const = 0;
+
+    /**
+     * @brief Deja de pedir datos al dispositivo y conserva lo que ya se recibió
+     * @return true si read() seguirá entregando lo ya recibido hasta devolver 0; false
+     *         (por defecto) si la fuente no retiene lecturas propias
+     * @details Se llama al detener la captura (Q): una fuente con colas internas, como
+     *          MultiSerialSource, no pierde así lecturas que ya salieron del dispositivo
+     */
+    virtual bool stopAcquisition() {
+        return false;
+    }
+
+    /**
+     * @brief Obtiene los contadores de ingesta de la fuente
+     * @return Contadores actuales; las fuentes que no los llevan devuelven ceros
+     * @details Puede llamarse desde otro hilo (p. ej. el exportador de métricas)
+     */
+    virtual SourceStats getStats() const {
+        return SourceStats();
+    }
+
     /**
      * @brief Destructor virtual
      * @details Asegura la correcta destrucción de objetos derivados
      */
-    virtual ~DataSource() {}
+    virtual ~BasicDataSource() {}
 };
 
+typedef BasicDataSource<int> DataSource;  ///< Fuente de enteros (serial, chunks de la Fase 1)
+
 #endif
\ No newline at end of file
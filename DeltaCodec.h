@@ -0,0 +1,256 @@
+/**
+ * @file DeltaCodec.h
+ * @brief Codificación delta + varint por bloques para los chunks ordenados
+ * @details Un chunk DELTA es un ChunkHeader seguido de bloques independientes:
+ *          [DeltaBlockHeader: registros y bytes][payload]. En el payload cada registro
+ *          se guarda como la diferencia con el anterior (zigzag + varint LEB128); el
+ *          primero de cada bloque se compara contra cero, así un bloque se decodifica sin
+ *          leer los anteriores. En datos ordenados las diferencias son pequeñas y un int
+ *          ocupa 1-3 bytes en lugar de 4.
+ */
+
+#ifndef DELTACODEC_H
+#define DELTACODEC_H
+
+#include "BlockWriter.h"
+#include "Record.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const uint32_t DELTA_BLOCK_RECORDS = 4096; ///< Registros máximos por bloque
+
+/**
+ * @struct DeltaBlockHeader
+ * @brief Encabezado de 8 bytes de cada bloque delta
+ */
+struct DeltaBlockHeader {
+    uint32_t records;  ///< Registros del bloque (1..DELTA_BLOCK_RECORDS)
+    uint32_t bytes;    ///< Bytes del payload que sigue al encabezado
+};
+
+/**
+ * @brief Escribe un entero sin signo como varint (7 bits por byte, el bit alto indica continuación)
+ * @param value Valor a escribir
+ * @param out Destino con al menos 10 bytes libres
+ * @return Posición siguiente al último byte escrito
+ */
+inline uint8_t* putVarint(uint64_t value, uint8_t* out) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+/**
+ * @brief Lee un varint
+ * @param p Posición inicial; al volver apunta después del varint
+ * @param end Fin de los datos
+ * @param value Valor leído
+ * @return false si el varint está truncado o excede 64 bits
+ */
+inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Convierte un entero con signo para que los valores pequeños (±) den varints cortos
+ * @param value Valor con signo
+ * @return 0, -1, 1, -2... se convierten en 0, 1, 2, 3...
+ */
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Inversa de zigzagEncode
+ * @param value Valor codificado
+ * @return Valor con signo original
+ */
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @struct DeltaRecord
+ * @brief Codificación de un registro respecto del anterior
+ * @details Solo tiene especializaciones para los registros soportados (int,
+ *          TelemetryRecord y CountedValue); usar otro tipo con ChunkFormat::DELTA no compila.
+ *          MAX_BYTES acota el tamaño codificado de un registro.
+ */
+template<typename T>
+struct DeltaRecord;
+
+template<>
+struct DeltaRecord<int> {
+    static const size_t MAX_BYTES = 5;  ///< |diferencia| < 2^32: zigzag de 33 bits
+
+    static uint8_t* encode(const int& previous, const int& record, uint8_t* out) {
+        return putVarint(zigzagEncode(static_cast<int64_t>(record) - previous), out);
+    }
+
+    static bool decode(const int& previous, const uint8_t*& p, const uint8_t* end, int& record) {
+        uint64_t delta;
+        if (!getVarint(p, end, delta)) return false;
+        record = static_cast<int>(previous + zigzagDecode(delta));
+        return true;
+    }
+};
+
+/**
+ * @details La marca de tiempo se guarda como diferencia (aritmética módulo 2^64, así
+ *          no hay desborde); sensor y valor se guardan completos porque no guardan
+ *          relación con el registro anterior.
+ */
+template<>
+struct DeltaRecord<TelemetryRecord> {
+    static const size_t MAX_BYTES = 10 + 5 + 5;  ///< Marca de tiempo, sensor y valor
+
+    static uint8_t* encode(const TelemetryRecord& previous, const TelemetryRecord& record,
+                           uint8_t* out) {
+        uint64_t delta = static_cast<uint64_t>(record.timestamp) -
+                         static_cast<uint64_t>(previous.timestamp);
+        out = putVarint(zigzagEncode(static_cast<int64_t>(delta)), out);
+        out = putVarint(record.sensorId, out);
+        return putVarint(zigzagEncode(record.value), out);
+    }
+
+    static bool decode(const TelemetryRecord& previous, const uint8_t*& p, const uint8_t* end,
+                       TelemetryRecord& record) {
+        uint64_t delta;
+        uint64_t sensor;
+        uint64_t value;
+        if (!getVarint(p, end, delta) || !getVarint(p, end, sensor) || !getVarint(p, end, value)) {
+            return false;
+        }
+        record.timestamp = static_cast<int64_t>(static_cast<uint64_t>(previous.timestamp) +
+                                                static_cast<uint64_t>(zigzagDecode(delta)));
+        record.sensorId = static_cast<uint32_t>(sensor);
+        record.value = static_cast<int32_t>(zigzagDecode(value));
+        return true;
+    }
+};
+
+/**
+ * @details El valor se guarda como diferencia y las repeticiones como varint: el par
+ *          de un valor muy repetido ocupa 2-3 bytes.
+ */
+template<>
+struct DeltaRecord<CountedValue> {
+    static const size_t MAX_BYTES = 5 + 5;  ///< Diferencia de valor y repeticiones
+
+    static uint8_t* encode(const CountedValue& previous, const CountedValue& record,
+                           uint8_t* out) {
+        out = putVarint(zigzagEncode(static_cast<int64_t>(record.value) - previous.value), out);
+        return putVarint(record.count, out);
+    }
+
+    static bool decode(const CountedValue& previous, const uint8_t*& p, const uint8_t* end,
+                       CountedValue& record) {
+        uint64_t delta;
+        uint64_t count;
+        if (!getVarint(p, end, delta) || !getVarint(p, end, count)) {
+            return false;
+        }
+        record.value = static_cast<int32_t>(previous.value + zigzagDecode(delta));
+        record.count = static_cast<uint32_t>(count);
+        return true;
+    }
+};
+
+/**
+ * @class DeltaBlockEncoder
+ * @brief Acumula registros en un bloque delta y lo escribe al llenarse
+ * @details No es dueño del BlockWriter: cada append()/flush() recibe el destino, así el
+ *          mismo codificador sirve para todas las corridas de un generador. Llamar a
+ *          flush() antes de cerrar el archivo para escribir el último bloque parcial.
+ */
+template<typename T>
+class DeltaBlockEncoder {
+private:
+    std::vector<uint8_t> payload; ///< Bloque en construcción
+    uint8_t* cursor;              ///< Siguiente byte libre de payload
+    uint32_t records;             ///< Registros en el bloque actual
+    T previous;                   ///< Último registro codificado (T() al iniciar bloque)
+
+    DeltaBlockEncoder(const DeltaBlockEncoder&);            ///< No copiable
+    DeltaBlockEncoder& operator=(const DeltaBlockEncoder&); ///< No asignable
+
+public:
+    /**
+     * @brief Constructor que reserva el bloque de peor caso
+     */
+    DeltaBlockEncoder()
+        : payload(DELTA_BLOCK_RECORDS * DeltaRecord<T>::MAX_BYTES), records(0), previous() {
+        cursor = payload.data();
+    }
+
+    /**
+     * @brief Agrega un registro al bloque; si se completa, lo escribe
+     * @param out Destino del bloque
+     * @param record Registro a codificar
+     */
+    void append(BlockWriter& out, const T& record) {
+        cursor = DeltaRecord<T>::encode(previous, record, cursor);
+        previous = record;
+        if (++records == DELTA_BLOCK_RECORDS) {
+            flush(out);
+        }
+    }
+
+    /**
+     * @brief Escribe el bloque pendiente (si tiene registros) y empieza uno nuevo
+     * @param out Destino del bloque
+     */
+    void flush(BlockWriter& out) {
+        if (records == 0) return;
+
+        DeltaBlockHeader header;
+        header.records = records;
+        header.bytes = static_cast<uint32_t>(cursor - payload.data());
+        out.write(&header, sizeof(header));
+        out.write(payload.data(), header.bytes);
+
+        cursor = payload.data();
+        records = 0;
+        previous = T();
+    }
+};
+
+/**
+ * @brief Decodifica el payload de un bloque delta
+ * @param data Payload del bloque
+ * @param bytes Tamaño del payload
+ * @param records Registros declarados en el encabezado del bloque
+ * @param out Destino con espacio para DELTA_BLOCK_RECORDS registros
+ * @return false si el bloque está dañado (registros de más, bytes de más o de menos)
+ */
+template<typename T>
+bool decodeDeltaBlock(const uint8_t* data, size_t bytes, uint32_t records, T* out) {
+    if (records == 0 || records > DELTA_BLOCK_RECORDS) {
+        return false;
+    }
+
+    const uint8_t* p = data;
+    const uint8_t* end = data + bytes;
+    T previous = T();
+    for (uint32_t i = 0; i < records; i++) {
+        if (!DeltaRecord<T>::decode(previous, p, end, out[i])) {
+            return false;
+        }
+        previous = out[i];
+    }
+    return p == end;
+}
+
+#endif
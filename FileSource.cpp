@@ -1,32 +1,10 @@
 /**
 * @file FileSource.cpp
- * @brief Implementación de FileSource
+ * @brief Instancias de BasicFileSource compiladas una sola vez
  */
 
 #include "FileSource.h"
-#include <iostream>
 
-FileSource::FileSource(const std::string& filename) {
-    file.open(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
-    }
-}
-
-int FileSource::getNext() {
-    int value;
-    if (file >> value) {
-        return value;
-    }
-    return 0;
-}
-
-bool FileSource::hasMoreData() {
-    return file.good() && !file.eof();
-}
-
-FileSource::~FileSource() {
-    if (file.is_open()) {
-        file.close();
-    }
-}
\ No newline at end of file
+template class BasicFileSource<int>;
+template class BasicFileSource<TelemetryRecord>;
+template class BasicFileSource<CountedValue>;
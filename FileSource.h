@@ -2,38 +2,82 @@
 * @file FileSource.h
  * @brief Clase concreta para lectura de datos desde archivos
  * @details Hereda de DataSource e implementa lectura desde archivos temporales (.tmp)
+ *          en formato texto, binario o delta (detectado por el encabezado)
  */
 
 #ifndef FILESOURCE_H
 #define FILESOURCE_H
 
 #include "DataSource.h"
+#include "ChunkFile.h"
+#include "Record.h"
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <string>
+#include <vector>
 
 /**
- * @class FileSource
+ * @class BasicFileSource
  * @brief Fuente de datos que lee desde archivos
- * @details Lee datos enteros desde archivos temporales (chunks)
+ * @details Lee registros de tipo T desde archivos temporales (chunks). Los chunks
+ *          binarios se leen por bloques de BLOCK_RECORDS registros en lugar de dato por
+ *          dato, los delta bloque a bloque (se decodifican en el mismo arreglo) y los de
+ *          texto se interpretan con RecordText<T>.
  */
-class FileSource : public DataSource {
+template<typename T>
+class BasicFileSource : public BasicDataSource<T> {
 private:
+    static const int BLOCK_RECORDS = 4096; ///< Registros leídos por bloque en modo binario
+
     std::ifstream file; ///< Stream del archivo
+    T nextValue;        ///< Siguiente valor ya leído (lectura anticipada)
+    bool hasNext;       ///< Indica si nextValue contiene un dato válido
+    bool binary;        ///< true si el archivo es un chunk binario
+    bool delta;         ///< true si el chunk binario está en bloques delta
+    uint64_t remaining; ///< Registros binarios que faltan por leer del archivo
+    T* block;           ///< Bloque de registros binarios leídos
+    int blockSize;      ///< Registros válidos en block
+    int blockPos;       ///< Siguiente registro a entregar de block
+    std::vector<uint8_t> encoded; ///< Payload del bloque delta en lectura
+    ReadStatus status;  ///< Estado al agotarse los datos (fin normal o error)
+
+    BasicFileSource(const BasicFileSource&);            ///< No copiable
+    BasicFileSource& operator=(const BasicFileSource&); ///< No asignable
+
+    /**
+     * @brief Lee el siguiente bloque de registros binarios
+     * @return true si se leyó al menos un registro
+     */
+    bool fillBlock();
+
+    /**
+     * @brief Lee y decodifica el siguiente bloque delta en block
+     * @return true si se decodificó al menos un registro
+     */
+    bool fillDeltaBlock();
+
+    /**
+     * @brief Lee por anticipado el siguiente valor del archivo
+     * @details Así hasMoreData() es exacto y getNext() nunca devuelve un 0 espurio al final
+     */
+    void advance();
 
 public:
     /**
      * @brief Constructor que abre un archivo
      * @param filename Nombre del archivo a leer (ej: "chunk_XX.tmp")
-     * @details Abre el archivo especificado para lectura
+     * @details Abre el archivo especificado para lectura y detecta su formato
      */
-    FileSource(const std::string& filename);
+    BasicFileSource(const std::string& filename);
 
     /**
-     * @brief Lee y devuelve el siguiente entero del archivo
-     * @return int Siguiente valor leído
-     * @details Lee una línea y la convierte a entero
+     * @brief Lee y devuelve el siguiente registro del archivo
+     * @return Siguiente valor leído
+     * @details En texto lee una línea y la convierte; en binario toma el
+     *          siguiente registro del bloque
      */
-    int getNext() override;
+    T getNext() override;
 
     /**
      * @brief Verifica si hay más datos en el archivo
@@ -41,10 +85,189 @@ public:
      */
     bool hasMoreData() override;
 
+    /**
+     * @brief Lee un lote de registros
+     * @param out Arreglo destino
+     * @param max Capacidad de out
+     * @return Registros leídos; en modo binario se copian bloques completos con memcpy
+     */
+    size_t read(T* out, size_t max) override;
+
+    /**
+     * @brief Estado de la fuente
+     * @return OK, END_OF_DATA, o IO_ERROR si no se pudo abrir, el chunk está truncado,
+     *         su ancho de registro no es sizeof(T) o el texto no se puede interpretar
+     */
+    ReadStatus getStatus() const override;
+
+    /**
+     * @brief Indica si el archivo se detectó como chunk binario
+     * @return true si el formato es binario
+     */
+    bool isBinary() const;
+
     /**
      * @brief Destructor que cierra el archivo
      */
-    ~FileSource();
+    ~BasicFileSource();
 };
 
-#endif
\ No newline at end of file
+typedef BasicFileSource<int> FileSource;  ///< Lector de chunks de enteros
+
+template<typename T>
+BasicFileSource<T>::BasicFileSource(const std::string& filename)
+    : nextValue(), hasNext(false), binary(false), delta(false), remaining(0),
+      block(nullptr), blockSize(0), blockPos(0), status(ReadStatus::END_OF_DATA) {
+    file.open(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        status = ReadStatus::IO_ERROR;
+        return;
+    }
+
+    ChunkHeader header;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) && isChunkHeader(header)) {
+        if (header.keyWidth != sizeof(T)) {
+            std::cerr << "Error: Ancho de registro no soportado en " << filename << std::endl;
+            status = ReadStatus::IO_ERROR;
+            return;
+        }
+        binary = true;
+        delta = isDeltaChunk(header);
+        remaining = header.count;
+        block = new T[delta ? DELTA_BLOCK_RECORDS : BLOCK_RECORDS];
+    } else {
+        // Sin firma: chunk de texto, se vuelve a leer desde el inicio
+        file.clear();
+        file.seekg(0);
+    }
+
+    advance();
+}
+
+template<typename T>
+bool BasicFileSource<T>::fillBlock() {
+    if (remaining == 0) {
+        return false;
+    }
+    if (delta) {
+        return fillDeltaBlock();
+    }
+
+    uint64_t toRead = remaining < static_cast<uint64_t>(BLOCK_RECORDS) ? remaining : BLOCK_RECORDS;
+    file.read(reinterpret_cast<char*>(block), sizeof(T) * toRead);
+    blockSize = static_cast<int>(file.gcount() / sizeof(T));
+    blockPos = 0;
+
+    if (blockSize < static_cast<int>(toRead)) {
+        std::cerr << "Error: Chunk binario truncado" << std::endl;
+        remaining = 0;
+        status = ReadStatus::IO_ERROR;
+    } else {
+        remaining -= toRead;
+    }
+    return blockSize > 0;
+}
+
+template<typename T>
+bool BasicFileSource<T>::fillDeltaBlock() {
+    blockSize = 0;
+    blockPos = 0;
+
+    DeltaBlockHeader header;
+    bool ok = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof(header))) &&
+              header.records <= remaining && header.records <= DELTA_BLOCK_RECORDS;
+    if (ok) {
+        encoded.resize(header.bytes);
+        ok = header.bytes == 0 ||
+             file.read(reinterpret_cast<char*>(encoded.data()), header.bytes);
+    }
+    if (!ok || !decodeDeltaBlock(encoded.data(), header.bytes, header.records, block)) {
+        std::cerr << "Error: Chunk delta truncado o dañado" << std::endl;
+        remaining = 0;
+        status = ReadStatus::IO_ERROR;
+        return false;
+    }
+
+    blockSize = static_cast<int>(header.records);
+    remaining -= header.records;
+    return true;
+}
+
+template<typename T>
+void BasicFileSource<T>::advance() {
+    if (!binary) {
+        hasNext = RecordText<T>::read(file, nextValue);
+        if (!hasNext && !file.eof()) {
+            // El texto se detuvo antes del fin del archivo: no es un registro válido
+            status = ReadStatus::IO_ERROR;
+        }
+        return;
+    }
+
+    if (blockPos >= blockSize && !fillBlock()) {
+        hasNext = false;
+        return;
+    }
+    nextValue = block[blockPos++];
+    hasNext = true;
+}
+
+template<typename T>
+T BasicFileSource<T>::getNext() {
+    if (!hasNext) {
+        return T();
+    }
+    T value = nextValue;
+    advance();
+    return value;
+}
+
+template<typename T>
+bool BasicFileSource<T>::hasMoreData() {
+    return hasNext;
+}
+
+template<typename T>
+size_t BasicFileSource<T>::read(T* out, size_t max) {
+    size_t n = 0;
+    while (n < max && hasNext) {
+        out[n++] = nextValue;
+
+        if (binary) {
+            // El resto del bloque actual se copia de una vez
+            size_t available = static_cast<size_t>(blockSize - blockPos);
+            size_t take = available < max - n ? available : max - n;
+            std::memcpy(out + n, block + blockPos, take * sizeof(T));
+            n += take;
+            blockPos += static_cast<int>(take);
+        }
+        advance();
+    }
+    return n;
+}
+
+template<typename T>
+ReadStatus BasicFileSource<T>::getStatus() const {
+    return hasNext ? ReadStatus::OK : status;
+}
+
+template<typename T>
+bool BasicFileSource<T>::isBinary() const {
+    return binary;
+}
+
+template<typename T>
+BasicFileSource<T>::~BasicFileSource() {
+    delete[] block;
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+// Instancias compiladas en FileSource.cpp
+extern template class BasicFileSource<int>;
+extern template class BasicFileSource<TelemetryRecord>;
+extern template class BasicFileSource<CountedValue>;
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file FrameCodec.cpp
+ * @brief Implementación del protocolo de tramas COBS con CRC-16
+ */
+
+#include "FrameCodec.h"
+
+uint16_t crc16(const uint8_t* data, size_t size) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* input, size_t size, uint8_t* output) {
+    size_t codePos = 0;
+    size_t out = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < size; i++) {
+        if (input[i] == 0) {
+            output[codePos] = code;
+            codePos = out++;
+            code = 1;
+        } else {
+            output[out++] = input[i];
+            code++;
+            if (code == 0xFF) {
+                output[codePos] = code;
+                codePos = out++;
+                code = 1;
+            }
+        }
+    }
+    output[codePos] = code;
+    return out;
+}
+
+bool cobsDecode(const uint8_t* input, size_t size, uint8_t* output, size_t& outputSize) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < size) {
+        uint8_t code = input[in++];
+        if (code == 0 || in + code - 1 > size) {
+            return false;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (input[in] == 0) return false;
+            output[out++] = input[in++];
+        }
+        if (code != 0xFF && in < size) {
+            output[out++] = 0;
+        }
+    }
+
+    outputSize = out;
+    return true;
+}
+
+size_t encodeFrame(const int32_t* readings, int count, uint8_t* output) {
+    uint8_t payload[FRAME_MAX_PAYLOAD];
+    size_t size = 0;
+
+    payload[size++] = static_cast<uint8_t>(count);
+    for (int i = 0; i < count; i++) {
+        uint32_t v = static_cast<uint32_t>(readings[i]);
+        payload[size++] = static_cast<uint8_t>(v);
+        payload[size++] = static_cast<uint8_t>(v >> 8);
+        payload[size++] = static_cast<uint8_t>(v >> 16);
+        payload[size++] = static_cast<uint8_t>(v >> 24);
+    }
+
+    uint16_t crc = crc16(payload, size);
+    payload[size++] = static_cast<uint8_t>(crc);
+    payload[size++] = static_cast<uint8_t>(crc >> 8);
+
+    size_t encoded = cobsEncode(payload, size, output);
+    output[encoded++] = 0;
+    return encoded;
+}
+
+bool parseFramePayload(const uint8_t* payload, size_t size, int32_t* readings, int& count) {
+    if (size < 3) {
+        return false;
+    }
+
+    int n = payload[0];
+    if (n < 1 || n > FRAME_MAX_READINGS || size != static_cast<size_t>(1 + 4 * n + 2)) {
+        return false;
+    }
+
+    uint16_t expected = static_cast<uint16_t>(payload[size - 2] | (payload[size - 1] << 8));
+    if (crc16(payload, size - 2) != expected) {
+        return false;
+    }
+
+    const uint8_t* p = payload + 1;
+    for (int i = 0; i < n; i++, p += 4) {
+        readings[i] = static_cast<int32_t>(static_cast<uint32_t>(p[0]) |
+                                           (static_cast<uint32_t>(p[1]) << 8) |
+                                           (static_cast<uint32_t>(p[2]) << 16) |
+                                           (static_cast<uint32_t>(p[3]) << 24));
+    }
+    count = n;
+    return true;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file FrameCodec.h
+ * @brief Protocolo serial binario: tramas COBS con lecturas little-endian y CRC-16
+ * @details Formato de una trama antes de COBS:
+ *          [n: 1 byte][n lecturas int32 little-endian][CRC-16/CCITT de lo anterior, LE].
+ *          Tras codificar con COBS la trama no contiene bytes 0x00 y termina en 0x00.
+ */
+
+#ifndef FRAMECODEC_H
+#define FRAMECODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+static const int FRAME_MAX_READINGS = 64;                          ///< Lecturas máximas por trama
+static const size_t FRAME_MAX_PAYLOAD = 1 + 4 * FRAME_MAX_READINGS + 2; ///< Trama sin codificar
+static const size_t FRAME_MAX_ENCODED = FRAME_MAX_PAYLOAD + FRAME_MAX_PAYLOAD / 254 + 2; ///< COBS + 0x00
+
+/**
+ * @brief Calcula el CRC-16/CCITT-FALSE (polinomio 0x1021, valor inicial 0xFFFF)
+ * @param data Bytes de entrada
+ * @param size Número de bytes
+ * @return CRC de 16 bits
+ */
+uint16_t crc16(const uint8_t* data, size_t size);
+
+/**
+ * @brief Codifica un bloque con COBS (Consistent Overhead Byte Stuffing)
+ * @param input Bytes a codificar
+ * @param size Número de bytes
+ * @param output Destino con al menos size + size/254 + 1 bytes
+ * @return Bytes escritos (sin el delimitador 0x00)
+ */
+size_t cobsEncode(const uint8_t* input, size_t size, uint8_t* output);
+
+/**
+ * @brief Decodifica un bloque COBS (sin el delimitador 0x00)
+ * @param input Bytes codificados
+ * @param size Número de bytes codificados
+ * @param output Destino con al menos size bytes
+ * @param outputSize Bytes decodificados
+ * @return false si el bloque no es COBS válido
+ */
+bool cobsDecode(const uint8_t* input, size_t size, uint8_t* output, size_t& outputSize);
+
+/**
+ * @brief Arma una trama completa (COBS + delimitador) con varias lecturas
+ * @param readings Lecturas a enviar
+ * @param count Número de lecturas (1..FRAME_MAX_READINGS)
+ * @param output Destino con al menos FRAME_MAX_ENCODED bytes
+ * @return Bytes de la trama, incluido el 0x00 final
+ */
+size_t encodeFrame(const int32_t* readings, int count, uint8_t* output);
+
+/**
+ * @brief Valida y extrae las lecturas de una trama ya decodificada de COBS
+ * @param payload Bytes decodificados
+ * @param size Número de bytes
+ * @param readings Destino con espacio para FRAME_MAX_READINGS lecturas
+ * @param count Lecturas extraídas
+ * @return false si la longitud o el CRC no coinciden
+ */
+bool parseFramePayload(const uint8_t* payload, size_t size, int32_t* readings, int& count);
+
+#endif
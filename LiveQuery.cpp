@@ -0,0 +1,656 @@
+/**
+ * @file LiveQuery.cpp
+ * @brief Implementación de LiveIndex y QueryServer
+ */
+
+#include "LiveQuery.h"
+#include "ChunkFile.h"
+#include "DeltaCodec.h"
+#include "FileSource.h"
+#include "MappedFileSource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * @class ChunkView
+ * @brief Búsquedas sobre un chunk ordenado mapeado en memoria
+ * @details Un chunk binario se busca directamente en el mapeo; uno delta guarda una tabla
+ *          con el primer valor de cada bloque y decodifica solo el bloque necesario; uno de
+ *          texto se interpreta completo al abrirlo. QueryServer los conserva entre consultas.
+ */
+class ChunkView {
+private:
+    /**
+     * @struct Block
+     * @brief Bloque delta dentro del mapeo
+     */
+    struct Block {
+        const uint8_t* payload; ///< Payload del bloque
+        uint32_t bytes;         ///< Tamaño del payload
+        uint32_t records;       ///< Registros del bloque
+        int first;              ///< Primer valor (mínimo del bloque)
+        uint64_t before;        ///< Registros en los bloques anteriores
+    };
+
+    MappedRegion region;         ///< Archivo mapeado
+    const int* sorted;           ///< Registros (binario o texto interpretado)
+    size_t count;                ///< Registros de sorted
+    std::vector<int> parsed;     ///< Registros de un chunk de texto
+    std::vector<Block> blocks;   ///< Tabla de bloques de un chunk delta
+    std::vector<int> decoded;    ///< Bloque delta decodificado
+
+    ChunkView(const ChunkView&);            ///< No copiable
+    ChunkView& operator=(const ChunkView&); ///< No asignable
+
+    /**
+     * @brief Índice del primer bloque cuyo primer valor es >= value
+     * @param value Valor buscado
+     * @return Índice en blocks (blocks.size() si todos son menores)
+     */
+    size_t firstBlockNotBelow(int64_t value) const {
+        size_t lo = 0;
+        size_t hi = blocks.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (blocks[mid].first < value) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    /**
+     * @brief Decodifica un bloque delta en decoded
+     * @param index Bloque a decodificar
+     * @return false si el bloque está dañado
+     */
+    bool decode(size_t index) {
+        const Block& block = blocks[index];
+        return decodeDeltaBlock<int>(block.payload, block.bytes, block.records, decoded.data());
+    }
+
+public:
+    ChunkView() : sorted(nullptr), count(0) {}
+
+    /**
+     * @brief Mapea un chunk y prepara las búsquedas
+     * @param filename Archivo del chunk
+     * @return false si no se pudo abrir o está dañado
+     */
+    bool open(const std::string& filename) {
+        if (!region.open(filename)) {
+            return false;
+        }
+        const char* data = region.data();
+        size_t size = region.size();
+
+        ChunkHeader header;
+        bool binary = size >= sizeof(header);
+        if (binary) {
+            std::memcpy(&header, data, sizeof(header));
+            binary = isChunkHeader(header);
+        }
+        if (binary && header.keyWidth != sizeof(int)) {
+            return false;  // Chunk de otro tipo de registro (ej: pares de --aggregate)
+        }
+
+        if (!binary) {
+            const char* p = data;
+            const char* end = data + size;
+            int value;
+            while (RecordText<int>::parse(p, end, value)) {
+                parsed.push_back(value);
+            }
+            if (p < end) {
+                return false;  // Texto con bytes inválidos: no se consulta un chunk dañado
+            }
+            sorted = parsed.data();
+            count = parsed.size();
+            return true;
+        }
+
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data) + sizeof(header);
+        const uint8_t* end = reinterpret_cast<const uint8_t*>(data) + size;
+
+        if (!isDeltaChunk(header)) {
+            if (static_cast<uint64_t>(end - p) / sizeof(int) < header.count) {
+                return false;
+            }
+            sorted = reinterpret_cast<const int*>(p);
+            count = static_cast<size_t>(header.count);
+            return true;
+        }
+
+        uint64_t total = 0;
+        while (total < header.count) {
+            DeltaBlockHeader blockHeader;
+            if (static_cast<size_t>(end - p) < sizeof(blockHeader)) return false;
+            std::memcpy(&blockHeader, p, sizeof(blockHeader));
+            p += sizeof(blockHeader);
+            if (blockHeader.records == 0 || static_cast<size_t>(end - p) < blockHeader.bytes) {
+                return false;
+            }
+
+            Block block;
+            block.payload = p;
+            block.bytes = blockHeader.bytes;
+            block.records = blockHeader.records;
+            block.before = total;
+            const uint8_t* q = p;
+            if (!DeltaRecord<int>::decode(0, q, p + blockHeader.bytes, block.first)) {
+                return false;
+            }
+            blocks.push_back(block);
+
+            p += blockHeader.bytes;
+            total += blockHeader.records;
+        }
+        decoded.resize(DELTA_BLOCK_RECORDS);
+        return true;
+    }
+
+    /**
+     * @brief Cuenta los registros menores que un valor
+     * @param value Valor de corte
+     * @return Registros < value
+     */
+    uint64_t countBelow(int64_t value) {
+        if (blocks.empty()) {
+            const int* it = std::lower_bound(sorted, sorted + count, value,
+                                             [](int a, int64_t b) { return a < b; });
+            return static_cast<uint64_t>(it - sorted);
+        }
+
+        // Todos los bloques anteriores al último que empieza debajo de value son menores
+        size_t index = firstBlockNotBelow(value);
+        if (index == 0) return 0;
+        const Block& block = blocks[index - 1];
+        if (!decode(index - 1)) return block.before;
+        const int* it = std::lower_bound(decoded.data(), decoded.data() + block.records, value,
+                                         [](int a, int64_t b) { return a < b; });
+        return block.before + static_cast<uint64_t>(it - decoded.data());
+    }
+
+    /**
+     * @brief Agrega los registros en [low, high] a out
+     * @param low Límite inferior
+     * @param high Límite superior
+     * @param limit Tamaño máximo de out
+     * @param out Valores encontrados, en orden
+     */
+    void collect(int64_t low, int64_t high, size_t limit, std::vector<int>& out) {
+        if (blocks.empty()) {
+            const int* it = std::lower_bound(sorted, sorted + count, low,
+                                             [](int a, int64_t b) { return a < b; });
+            for (; it != sorted + count && *it <= high && out.size() < limit; ++it) {
+                out.push_back(*it);
+            }
+            return;
+        }
+
+        size_t index = firstBlockNotBelow(low);
+        if (index > 0) index--;
+        for (; index < blocks.size() && out.size() < limit; index++) {
+            if (blocks[index].first > high || !decode(index)) return;
+            for (uint32_t i = 0; i < blocks[index].records && out.size() < limit; i++) {
+                if (decoded[i] > high) return;
+                if (decoded[i] >= low) out.push_back(decoded[i]);
+            }
+        }
+    }
+};
+
+namespace {
+
+/**
+ * @class QueryData
+ * @brief Chunks mapeados y memoria ordenada de una instantánea
+ */
+class QueryData {
+private:
+    std::vector<ChunkView*> views;  ///< Chunks abiertos (propiedad de QueryServer)
+    std::vector<int> memory;        ///< Copia ordenada del buffer en llenado
+
+    QueryData(const QueryData&);            ///< No copiable
+    QueryData& operator=(const QueryData&); ///< No asignable
+
+public:
+    uint64_t total;     ///< Registros consultables
+    int64_t minValue;   ///< Mínimo (válido si total > 0)
+    int64_t maxValue;   ///< Máximo (válido si total > 0)
+
+    /**
+     * @brief Reúne los chunks de la instantánea y ordena la memoria
+     * @param snapshot Instantánea a consultar
+     * @param chunkViews Chunk abierto de cada entrada de snapshot.chunks con registros
+     */
+    QueryData(const LiveSnapshot& snapshot, const std::vector<ChunkView*>& chunkViews)
+        : views(chunkViews), memory(snapshot.memory), total(0),
+          minValue(std::numeric_limits<int64_t>::max()),
+          maxValue(std::numeric_limits<int64_t>::min()) {
+        std::sort(memory.begin(), memory.end());
+        if (!memory.empty()) {
+            total = memory.size();
+            minValue = memory.front();
+            maxValue = memory.back();
+        }
+
+        for (size_t i = 0; i < snapshot.chunks.size(); i++) {
+            const LiveChunk& chunk = snapshot.chunks[i];
+            if (chunk.count == 0) continue;
+            total += chunk.count;
+            minValue = std::min<int64_t>(minValue, chunk.minValue);
+            maxValue = std::max<int64_t>(maxValue, chunk.maxValue);
+        }
+    }
+
+    /**
+     * @brief Cuenta los registros menores que un valor
+     * @param value Valor de corte
+     * @return Registros < value en todos los chunks y en memoria
+     */
+    uint64_t rank(int64_t value) {
+        uint64_t result = static_cast<uint64_t>(
+            std::lower_bound(memory.begin(), memory.end(), value,
+                             [](int a, int64_t b) { return a < b; }) - memory.begin());
+        for (size_t i = 0; i < views.size(); i++) {
+            result += views[i]->countBelow(value);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Obtiene el k-ésimo registro en orden (desde 0)
+     * @param k Posición; debe ser menor que total
+     * @return Valor en la posición k
+     * @details Búsqueda binaria sobre el rango de valores: unas 32 consultas de rank
+     */
+    int64_t select(uint64_t k) {
+        int64_t lo = minValue;
+        int64_t hi = maxValue;
+        while (lo < hi) {
+            int64_t mid = lo + (hi - lo) / 2;
+            if (rank(mid + 1) > k) hi = mid;
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+
+    /**
+     * @brief Obtiene hasta limit registros del rango [low, high], en orden
+     * @param low Límite inferior
+     * @param high Límite superior
+     * @param limit Registros máximos
+     * @return Valores ordenados
+     */
+    std::vector<int> collect(int64_t low, int64_t high, size_t limit) {
+        // Los primeros limit de cada fuente alcanzan para los primeros limit del total
+        std::vector<int> values;
+        std::vector<int>::iterator it = std::lower_bound(memory.begin(), memory.end(), low,
+                                                         [](int a, int64_t b) { return a < b; });
+        for (; it != memory.end() && *it <= high && values.size() < limit; ++it) {
+            values.push_back(*it);
+        }
+        for (size_t i = 0; i < views.size(); i++) {
+            std::vector<int> part;
+            views[i]->collect(low, high, limit, part);
+            values.insert(values.end(), part.begin(), part.end());
+        }
+        std::sort(values.begin(), values.end());
+        if (values.size() > limit) values.resize(limit);
+        return values;
+    }
+};
+
+/**
+ * @brief Lee un entero de 64 bits de una consulta
+ * @param in Consulta
+ * @param value Valor leído
+ * @return false si falta o no es un número
+ */
+bool readNumber(std::istringstream& in, long long& value) {
+    return static_cast<bool>(in >> value);
+}
+
+} // namespace
+
+// ============= LIVEINDEX =============
+LiveIndex::LiveIndex()
+    : pending(0), acquiring(false), snapshotRequested(false), snapshotSerial(0) {}
+
+bool LiveIndex::addChunkFile(const std::string& filename) {
+    ChunkHeader header;
+    LiveChunk chunk;
+    chunk.filename = filename;
+
+    if (readChunkHeader(filename, header) && isChunkHeader(header)) {
+        chunk.count = header.count;
+        chunk.minValue = static_cast<int>(header.minKey);
+        chunk.maxValue = static_cast<int>(header.maxKey);
+    } else {
+        // Chunk de texto: sin encabezado, se recorre para contar
+        FileSource source(filename);
+        int value;
+        bool first = true;
+        while (source.read(&value, 1) == 1) {
+            if (first) chunk.minValue = value;
+            chunk.maxValue = value;
+            chunk.count++;
+            first = false;
+        }
+        if (source.getStatus() == ReadStatus::IO_ERROR) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    chunks.push_back(chunk);
+    return true;
+}
+
+void LiveIndex::addPending(uint64_t records) {
+    std::lock_guard<std::mutex> lock(mtx);
+    pending += records;
+}
+
+void LiveIndex::chunkWritten(const LiveChunk& chunk) {
+    std::lock_guard<std::mutex> lock(mtx);
+    pending -= std::min(pending, chunk.count);
+    chunks.push_back(chunk);
+}
+
+void LiveIndex::chunkFailed(uint64_t records) {
+    std::lock_guard<std::mutex> lock(mtx);
+    pending -= std::min(pending, records);
+}
+
+void LiveIndex::setAcquiring(bool active) {
+    std::lock_guard<std::mutex> lock(mtx);
+    acquiring = active;
+    snapshotDone.notify_all();
+}
+
+void LiveIndex::takeSnapshot(CircularBuffer& buffer) {
+    std::lock_guard<std::mutex> lock(mtx);
+    snapshotRequested.store(false, std::memory_order_relaxed);
+
+    lastSnapshot.chunks = chunks;
+    lastSnapshot.pending = pending;
+    lastSnapshot.stale = false;
+    lastSnapshot.memory.resize(static_cast<size_t>(buffer.size()));
+    if (!lastSnapshot.memory.empty()) {
+        buffer.getData(lastSnapshot.memory.data(), buffer.size());
+    }
+
+    snapshotSerial++;
+    snapshotDone.notify_all();
+}
+
+LiveSnapshot LiveIndex::snapshot(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(mtx);
+
+    if (acquiring) {
+        uint64_t serial = snapshotSerial;
+        snapshotRequested.store(true, std::memory_order_release);
+        snapshotDone.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&]() {
+            return snapshotSerial != serial || !acquiring;
+        });
+        if (snapshotSerial != serial) {
+            return lastSnapshot;
+        }
+        if (acquiring) {
+            // La adquisición está esperando datos del puerto: se responde con la última copia
+            LiveSnapshot previous = lastSnapshot;
+            previous.stale = true;
+            return previous;
+        }
+    }
+
+    // Sin adquisición activa todos los datos están en chunks (o pendientes de escribir)
+    LiveSnapshot result;
+    result.chunks = chunks;
+    result.pending = pending;
+    return result;
+}
+
+// ============= QUERYSERVER =============
+QueryServer::QueryServer(LiveIndex& liveIndex, const std::string& path)
+    : index(liveIndex), socketPath(path), listenFd(-1), stopping(false) {}
+
+std::string QueryServer::answer(const std::string& request) {
+    std::istringstream in(request);
+    std::string command;
+    if (!(in >> command)) {
+        return "error=consulta vacía";
+    }
+
+    if (command == "help") {
+        return "comandos: count | min | max | median | rank V | select K | range A B [LÍMITE]";
+    }
+
+    long long first = 0;
+    long long second = 0;
+    long long limit = static_cast<long long>(DEFAULT_RANGE_LIMIT);
+    if (command == "rank" || command == "select") {
+        if (!readNumber(in, first)) return "error=falta el valor";
+    } else if (command == "range") {
+        if (!readNumber(in, first) || !readNumber(in, second)) return "error=faltan los límites";
+        if (!readNumber(in, limit)) limit = static_cast<long long>(DEFAULT_RANGE_LIMIT);
+        if (limit < 0) limit = 0;
+        // Fuera del rango de int no hay datos: así second + 1 no desborda
+        first = std::max<long long>(first, std::numeric_limits<int>::min());
+        second = std::min<long long>(second, std::numeric_limits<int>::max());
+    } else if (command != "count" && command != "min" && command != "max" &&
+               command != "median") {
+        return "error=comando desconocido";
+    }
+
+    LiveSnapshot snapshot = index.snapshot(SNAPSHOT_TIMEOUT_MS);
+    std::vector<ChunkView*> chunkViews;
+    for (size_t i = 0; i < snapshot.chunks.size(); i++) {
+        if (snapshot.chunks[i].count == 0) continue;
+        ChunkView* view = openChunk(snapshot.chunks[i].filename);
+        if (view == nullptr) {
+            return "error=no se pudo leer " + snapshot.chunks[i].filename;
+        }
+        chunkViews.push_back(view);
+    }
+    QueryData data(snapshot, chunkViews);
+
+    std::ostringstream out;
+    if (command == "count") {
+        out << "count=" << data.total << " chunks=" << snapshot.chunks.size()
+            << " memory=" << snapshot.memory.size() << " pending=" << snapshot.pending;
+    } else if (command == "rank") {
+        out << "rank=" << data.rank(first);
+    } else if (command == "range") {
+        uint64_t count = first <= second ? data.rank(second + 1) - data.rank(first) : 0;
+        std::vector<int> values = count > 0
+            ? data.collect(first, second, static_cast<size_t>(limit)) : std::vector<int>();
+        out << "count=" << count << " values=";
+        for (size_t i = 0; i < values.size(); i++) {
+            out << (i > 0 ? "," : "") << values[i];
+        }
+    } else if (data.total == 0) {
+        return "error=sin datos";
+    } else if (command == "min") {
+        out << "min=" << data.minValue;
+    } else if (command == "max") {
+        out << "max=" << data.maxValue;
+    } else if (command == "median") {
+        out << "median=" << data.select((data.total - 1) / 2);
+    } else {
+        if (first < 0 || static_cast<uint64_t>(first) >= data.total) {
+            return "error=posición fuera de rango";
+        }
+        out << "select=" << data.select(static_cast<uint64_t>(first));
+    }
+
+    if (snapshot.stale) {
+        out << " stale=1";
+    }
+    if (snapshot.pending > 0 && command != "count") {
+        // Buffers que un trabajador está ordenando: la respuesta no los incluye todavía
+        out << " partial=" << snapshot.pending;
+    }
+    return out.str();
+}
+
+ChunkView* QueryServer::openChunk(const std::string& filename) {
+    std::map<std::string, ChunkView*>::iterator it = views.find(filename);
+    if (it != views.end()) {
+        return it->second;
+    }
+    ChunkView* view = new ChunkView();
+    if (!view->open(filename)) {
+        delete view;
+        return nullptr;
+    }
+    views[filename] = view;
+    return view;
+}
+
+void QueryServer::closeChunks() {
+    for (std::map<std::string, ChunkView*>::iterator it = views.begin(); it != views.end(); ++it) {
+        delete it->second;
+    }
+    views.clear();
+}
+
+#ifdef _WIN32
+// ============= IMPLEMENTACIÓN WINDOWS =============
+bool QueryServer::start() {
+    std::cerr << "Advertencia: Las consultas en vivo (socket UNIX) no están disponibles en Windows"
+              << std::endl;
+    return false;
+}
+
+void QueryServer::stop() {
+    closeChunks();
+}
+
+void QueryServer::serverLoop() {}
+
+void QueryServer::serveClient(int clientFd) {
+    (void)clientFd;
+}
+#else
+// ============= IMPLEMENTACIÓN LINUX =============
+bool QueryServer::start() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Ruta de socket demasiado larga: " << socketPath << std::endl;
+        return false;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd == -1) {
+        std::cerr << "Error: No se pudo crear el socket de consultas" << std::endl;
+        return false;
+    }
+
+    // Un socket de una ejecución anterior impediría el bind
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, 4) != 0) {
+        std::cerr << "Error: No se pudo escuchar en " << socketPath << ": "
+                  << std::strerror(errno) << std::endl;
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    stopping = false;
+    thread = std::thread(&QueryServer::serverLoop, this);
+    return true;
+}
+
+void QueryServer::stop() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    closeChunks();
+    if (listenFd != -1) {
+        ::close(listenFd);
+        listenFd = -1;
+        unlink(socketPath.c_str());
+    }
+}
+
+void QueryServer::serverLoop() {
+    while (!stopping) {
+        // Espera acotada para revisar la solicitud de detención
+        pollfd pfd;
+        pfd.fd = listenFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 200) <= 0) {
+            continue;
+        }
+
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd == -1) {
+            continue;
+        }
+        serveClient(clientFd);
+        ::close(clientFd);
+    }
+}
+
+void QueryServer::serveClient(int clientFd) {
+    std::string pending;
+    char chunk[256];
+
+    while (!stopping) {
+        pollfd pfd;
+        pfd.fd = clientFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ready = poll(&pfd, 1, 200);
+        if (ready == 0) continue;
+        if (ready < 0) return;
+
+        ssize_t n = ::read(clientFd, chunk, sizeof(chunk));
+        if (n <= 0) return;
+        pending.append(chunk, static_cast<size_t>(n));
+
+        size_t newline;
+        while ((newline = pending.find('\n')) != std::string::npos) {
+            std::string request = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            if (!request.empty() && request[request.size() - 1] == '\r') {
+                request.erase(request.size() - 1);
+            }
+
+            std::string response = answer(request) + "\n";
+            const char* p = response.data();
+            size_t left = response.size();
+            while (left > 0) {
+                ssize_t sent = send(clientFd, p, left, MSG_NOSIGNAL);
+                if (sent <= 0) return;
+                p += sent;
+                left -= static_cast<size_t>(sent);
+            }
+        }
+    }
+}
+#endif
+
+QueryServer::~QueryServer() {
+    stop();
+}
@@ -0,0 +1,227 @@
+/**
+ * @file LiveQuery.h
+ * @brief Consultas en vivo (mínimo, máximo, mediana, rango, rango ordinal) durante la captura
+ * @details LiveIndex lleva la lista de chunks ya escritos y los datos en tránsito; un
+ *          QueryServer responde consultas por un socket UNIX local buscando en los chunks
+ *          ordenados (mapeados en memoria) y en una copia del CircularBuffer que se está
+ *          llenando. La copia la hace el hilo de adquisición entre lotes y solo cuando hay
+ *          una consulta pendiente, así la lectura del serial no se detiene.
+ *
+ * Protocolo (una línea por consulta, una línea de respuesta):
+ *   count                 -> count=N chunks=C memory=M pending=P
+ *                            (P: buffers en ordenamiento, aún fuera de N y de las demás)
+ *   min | max | median    -> min=V | max=V | median=V
+ *   rank V                -> rank=N   (datos menores que V)
+ *   select K              -> select=V (K-ésimo dato, desde 0)
+ *   range A B [LÍMITE]    -> count=N values=v1,v2,...  (datos en [A, B])
+ * Mientras haya pendientes las respuestas no los incluyen y terminan en " partial=P".
+ */
+
+#ifndef LIVEQUERY_H
+#define LIVEQUERY_H
+
+#include "CircularBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct LiveChunk
+ * @brief Chunk ordenado ya escrito y disponible para consultas
+ */
+struct LiveChunk {
+    std::string filename;   ///< Archivo del chunk
+    uint64_t count;         ///< Registros del chunk
+    int minValue;           ///< Primer valor (mínimo)
+    int maxValue;           ///< Último valor (máximo)
+
+    LiveChunk() : count(0), minValue(0), maxValue(0) {}
+    LiveChunk(const std::string& f, uint64_t c, int lo, int hi)
+        : filename(f), count(c), minValue(lo), maxValue(hi) {}
+};
+
+/**
+ * @struct LiveSnapshot
+ * @brief Estado consistente de los datos capturados en un instante
+ */
+struct LiveSnapshot {
+    std::vector<LiveChunk> chunks;  ///< Chunks escritos
+    std::vector<int> memory;        ///< Datos del buffer en llenado (sin ordenar)
+    uint64_t pending;               ///< Datos entregados a los trabajadores y aún no escritos
+    bool stale;                     ///< true si memory es de una copia anterior (sin respuesta a tiempo)
+
+    LiveSnapshot() : pending(0), stale(false) {}
+};
+
+/**
+ * @class LiveIndex
+ * @brief Registro compartido entre la adquisición, los trabajadores y el servidor de consultas
+ * @details Los datos de un buffer pasan de "memoria" a "pendientes" al entregarse al
+ *          ChunkPipeline y de "pendientes" a un chunk al escribirse; la copia se toma con
+ *          el mutex tomado en el hilo de adquisición, por lo que ningún dato se cuenta dos
+ *          veces. Los pendientes (a lo sumo los buffers en rotación) se informan aparte.
+ */
+class LiveIndex {
+private:
+    mutable std::mutex mtx;                ///< Protege todo el estado salvo snapshotRequested
+    std::condition_variable snapshotDone;  ///< Avisa que la adquisición tomó una copia
+    std::vector<LiveChunk> chunks;         ///< Chunks escritos
+    uint64_t pending;                      ///< Datos en tránsito hacia un chunk
+    bool acquiring;                        ///< La Fase 1 está leyendo datos
+    std::atomic<bool> snapshotRequested;   ///< Una consulta espera copia del buffer
+    uint64_t snapshotSerial;               ///< Copias tomadas (para detectar una nueva)
+    LiveSnapshot lastSnapshot;             ///< Última copia tomada por la adquisición
+
+    LiveIndex(const LiveIndex&);            ///< No copiable
+    LiveIndex& operator=(const LiveIndex&); ///< No asignable
+
+    /**
+     * @brief Copia el buffer, los chunks y los pendientes (hilo de adquisición)
+     * @param buffer Buffer que se está llenando
+     */
+    void takeSnapshot(CircularBuffer& buffer);
+
+public:
+    /**
+     * @brief Constructor de un índice vacío
+     */
+    LiveIndex();
+
+    /**
+     * @brief Registra un chunk existente (por ejemplo, uno reutilizado por --resume)
+     * @param filename Archivo del chunk
+     * @return false si no se pudo leer
+     * @details Toma registros, mínimo y máximo del encabezado; un chunk de texto se recorre
+     */
+    bool addChunkFile(const std::string& filename);
+
+    /**
+     * @brief Marca los datos de un buffer entregado a los trabajadores
+     * @param records Datos del buffer
+     */
+    void addPending(uint64_t records);
+
+    /**
+     * @brief Pasa un buffer de pendiente a chunk escrito (hilo trabajador)
+     * @param chunk Chunk escrito
+     */
+    void chunkWritten(const LiveChunk& chunk);
+
+    /**
+     * @brief Descarta un buffer pendiente cuyo chunk no se pudo escribir
+     * @param records Datos del buffer
+     */
+    void chunkFailed(uint64_t records);
+
+    /**
+     * @brief Indica si la adquisición está activa (y puede atender copias del buffer)
+     * @param active true al iniciar la Fase 1, false tras entregar el último buffer
+     */
+    void setAcquiring(bool active);
+
+    /**
+     * @brief Atiende una consulta pendiente copiando el buffer en llenado
+     * @param buffer Buffer que se está llenando
+     * @details Se llama entre lotes desde el hilo de adquisición; sin consultas cuesta
+     *          una lectura atómica
+     */
+    void serviceSnapshot(CircularBuffer& buffer) {
+        if (snapshotRequested.load(std::memory_order_acquire)) {
+            takeSnapshot(buffer);
+        }
+    }
+
+    /**
+     * @brief Obtiene un estado consistente para responder una consulta
+     * @param timeoutMs Espera máxima por la copia del buffer
+     * @return Estado; si la adquisición no responde a tiempo se usa la última copia (stale)
+     */
+    LiveSnapshot snapshot(int timeoutMs);
+};
+
+class ChunkView;
+
+/**
+ * @class QueryServer
+ * @brief Servidor de consultas en vivo sobre un socket UNIX (un cliente a la vez)
+ * @details En Windows no hay socket: start() avisa y devuelve false.
+ */
+class QueryServer {
+private:
+    LiveIndex& index;              ///< Datos a consultar
+    std::string socketPath;        ///< Ruta del socket
+    int listenFd;                  ///< Socket de escucha (-1 si no se inició)
+    std::atomic<bool> stopping;    ///< Solicita terminar al hilo del servidor
+    std::thread thread;            ///< Hilo que acepta y atiende clientes
+    std::map<std::string, ChunkView*> views; ///< Chunks abiertos en consultas anteriores
+
+    /**
+     * @brief Obtiene un chunk preparado para búsquedas, abriéndolo la primera vez
+     * @param filename Archivo del chunk
+     * @return Chunk abierto, o nullptr si no se pudo leer
+     * @details Un chunk no cambia después de escrito: el mapeo, la tabla de bloques delta
+     *          y los valores de un chunk de texto ya interpretado sirven a las consultas
+     *          siguientes
+     */
+    ChunkView* openChunk(const std::string& filename);
+
+    /**
+     * @brief Cierra los chunks abiertos por las consultas
+     */
+    void closeChunks();
+
+    QueryServer(const QueryServer&);            ///< No copiable
+    QueryServer& operator=(const QueryServer&); ///< No asignable
+
+    /**
+     * @brief Bucle del hilo del servidor
+     */
+    void serverLoop();
+
+    /**
+     * @brief Atiende las consultas de un cliente hasta que cierre la conexión
+     * @param clientFd Socket del cliente
+     */
+    void serveClient(int clientFd);
+
+public:
+    static const int SNAPSHOT_TIMEOUT_MS = 2500; ///< Espera máxima por la copia del buffer
+    static const size_t DEFAULT_RANGE_LIMIT = 20; ///< Valores listados por "range" sin límite
+
+    /**
+     * @brief Constructor
+     * @param liveIndex Datos a consultar
+     * @param path Ruta del socket (ej: "esort.sock")
+     */
+    QueryServer(LiveIndex& liveIndex, const std::string& path);
+
+    /**
+     * @brief Crea el socket y arranca el hilo del servidor
+     * @return false si no se pudo crear el socket
+     */
+    bool start();
+
+    /**
+     * @brief Detiene el servidor, cierra los chunks abiertos y elimina el socket
+     */
+    void stop();
+
+    /**
+     * @brief Responde una consulta
+     * @param request Línea de consulta (ver el protocolo en el encabezado del archivo)
+     * @return Línea de respuesta sin '\n'
+     */
+    std::string answer(const std::string& request);
+
+    /**
+     * @brief Destructor que detiene el servidor
+     */
+    ~QueryServer();
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file Logger.cpp
+ * @brief Implementación de LogRateLimit y Logger
+ */
+
+#include "Logger.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Milisegundos de un reloj monótono
+ * @return Tiempo actual en ms
+ */
+int64_t monotonicMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Copia un texto a un mensaje de tamaño fijo, recortándolo si no cabe
+ * @param entry Mensaje destino
+ * @param level Nivel
+ * @param text Texto
+ */
+void fillEntry(LogEntry& entry, LogLevel level, const std::string& text) {
+    size_t length = text.size();
+    if (length > LogEntry::TEXT_BYTES) {
+        length = LogEntry::TEXT_BYTES;
+        std::memcpy(entry.text, text.data(), length - 3);
+        std::memcpy(entry.text + length - 3, "...", 3);
+    } else {
+        std::memcpy(entry.text, text.data(), length);
+    }
+    entry.level = level;
+    entry.length = static_cast<uint16_t>(length);
+}
+
+} // namespace
+
+// ============= LOGRATELIMIT =============
+LogRateLimit::LogRateLimit(uint32_t messages, int intervalMs)
+    : perWindow(messages), windowMs(intervalMs), windowStart(monotonicMs()), used(0),
+      suppressed(0) {}
+
+bool LogRateLimit::allow(uint64_t& skipped) {
+    int64_t now = monotonicMs();
+    int64_t start = windowStart.load(std::memory_order_relaxed);
+    if (now - start >= windowMs &&
+        windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        used.store(0, std::memory_order_relaxed);
+    }
+    if (used.fetch_add(1, std::memory_order_relaxed) >= perWindow) {
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    skipped = suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+// ============= LOGGER =============
+// Definiciones de las constantes: wait_for() las toma por referencia
+const size_t Logger::QUEUE_ENTRIES;
+const int Logger::WRITE_INTERVAL_MS;
+
+Logger::Logger()
+    : threshold(static_cast<int>(LogLevel::INFO)), queue(QUEUE_ENTRIES), running(false),
+      accepted(0), dropped(0), droppedReported(0), drained(0), stopping(false) {}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+bool Logger::parseLevel(const std::string& name, LogLevel& level) {
+    if (name == "error") level = LogLevel::ERR;
+    else if (name == "warn") level = LogLevel::WARN;
+    else if (name == "info") level = LogLevel::INFO;
+    else if (name == "debug") level = LogLevel::DEBUG;
+    else if (name == "trace") level = LogLevel::TRACE;
+    else return false;
+    return true;
+}
+
+void Logger::setLevel(LogLevel level) {
+    threshold.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+void Logger::emit(const LogEntry& entry) {
+    if (entry.level == LogLevel::ERR) {
+        std::cerr << "Error: ";
+    } else if (entry.level == LogLevel::WARN) {
+        std::cerr << "Advertencia: ";
+    }
+    std::ostream& out = entry.level <= LogLevel::WARN ? std::cerr : std::cout;
+    out.write(entry.text, entry.length);
+    out << '\n';
+}
+
+void Logger::write(LogLevel level, const std::string& text) {
+    if (!enabled(level)) {
+        return;
+    }
+
+    LogEntry entry;
+    fillEntry(entry, level, text);
+    if (running.load(std::memory_order_acquire)) {
+        if (queue.tryPush(entry)) {
+            accepted.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        if (level != LogLevel::ERR) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    // Sin hilo escritor, o un error con la cola llena: se escribe en el momento
+    std::lock_guard<std::mutex> lock(outputMtx);
+    emit(entry);
+    std::cout.flush();
+}
+
+uint64_t Logger::drainQueue() {
+    uint64_t written = 0;
+    LogEntry entry;
+    std::lock_guard<std::mutex> lock(outputMtx);
+    while (queue.tryPop(entry)) {
+        emit(entry);
+        written++;
+    }
+
+    uint64_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost != droppedReported) {
+        std::cerr << "Advertencia: " << lost - droppedReported
+                  << " mensajes descartados (cola de registro llena)\n";
+        droppedReported = lost;
+    }
+    if (written > 0) {
+        // Un flush por vaciado, no por línea
+        std::cout.flush();
+    }
+    return written;
+}
+
+void Logger::writerLoop() {
+    while (true) {
+        bool finishing;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            // Sin predicado: flush() y stop() despiertan al escritor con notify
+            if (!stopping) {
+                wakeCv.wait_for(lock, std::chrono::milliseconds(WRITE_INTERVAL_MS));
+            }
+            finishing = stopping;
+        }
+
+        uint64_t written = drainQueue();
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            drained += written;
+        }
+        drainedCv.notify_all();
+
+        if (finishing) {
+            break;
+        }
+    }
+}
+
+void Logger::start() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (writer.joinable()) {
+        return;
+    }
+    stopping = false;
+    writer = std::thread(&Logger::writerLoop, this);
+    running.store(true, std::memory_order_release);
+}
+
+void Logger::flush() {
+    if (!running.load(std::memory_order_acquire)) {
+        return;
+    }
+    uint64_t target = accepted.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mtx);
+    wakeCv.notify_one();
+    drainedCv.wait(lock, [this, target]() { return drained >= target || stopping; });
+}
+
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!writer.joinable()) {
+            return;
+        }
+        stopping = true;
+    }
+    wakeCv.notify_one();
+    writer.join();
+
+    // Lo que se encoló mientras el escritor terminaba
+    running.store(false, std::memory_order_release);
+    drainQueue();
+    std::cerr.flush();
+}
+
+uint64_t Logger::getDropped() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+Logger::~Logger() {
+    stop();
+}
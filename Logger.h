@@ -0,0 +1,199 @@
+/**
+ * @file Logger.h
+ * @brief Registro de mensajes por niveles, asíncrono y con límite de frecuencia
+ * @details Los hilos de adquisición, los trabajadores y la fusión encolan sus mensajes
+ *          en una cola sin bloqueos; un hilo aparte los escribe en la consola. Así la
+ *          ruta caliente nunca espera a la terminal: un mensaje cuesta una copia a la
+ *          cola, y uno de un nivel desactivado solo una lectura atómica.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "MpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @enum LogLevel
+ * @brief Nivel de un mensaje; se escriben los de nivel menor o igual al configurado
+ * @details ERR en lugar de ERROR: windows.h define ERROR como macro
+ */
+enum class LogLevel {
+    ERR,        ///< Fallos (stderr, prefijo "Error: ")
+    WARN,       ///< Situaciones recuperables (stderr, prefijo "Advertencia: ")
+    INFO,       ///< Avance de las fases y progreso (por defecto)
+    DEBUG,      ///< Un mensaje por chunk o corrida escrita
+    TRACE       ///< Un mensaje por lectura (solo para depurar con pocos datos)
+};
+
+/**
+ * @struct LogEntry
+ * @brief Mensaje encolado, de tamaño fijo para no reservar memoria al registrar
+ */
+struct LogEntry {
+    static const size_t TEXT_BYTES = 240;  ///< Texto máximo; lo que sobra se recorta
+
+    LogLevel level;                 ///< Nivel del mensaje
+    uint16_t length;                ///< Bytes válidos de text
+    char text[TEXT_BYTES];          ///< Texto sin salto de línea final
+};
+
+/**
+ * @class LogRateLimit
+ * @brief Limita un mensaje repetitivo a N apariciones por ventana de tiempo
+ * @details Se declara una por origen (por ejemplo, una por puerto para los datos
+ *          inválidos). Es aproximado entre hilos: en el cambio de ventana puede dejar
+ *          pasar algún mensaje de más, nunca bloquea.
+ */
+class LogRateLimit {
+private:
+    uint32_t perWindow;                 ///< Mensajes permitidos por ventana
+    int64_t windowMs;                   ///< Duración de la ventana
+    std::atomic<int64_t> windowStart;   ///< Inicio de la ventana actual (ms monótonos)
+    std::atomic<uint32_t> used;         ///< Mensajes dejados pasar en la ventana
+    std::atomic<uint64_t> suppressed;   ///< Mensajes omitidos desde el último permitido
+
+    LogRateLimit(const LogRateLimit&);            ///< No copiable
+    LogRateLimit& operator=(const LogRateLimit&); ///< No asignable
+
+public:
+    /**
+     * @brief Constructor
+     * @param messages Mensajes permitidos por ventana
+     * @param intervalMs Duración de la ventana en milisegundos
+     */
+    LogRateLimit(uint32_t messages, int intervalMs);
+
+    /**
+     * @brief Indica si el mensaje se debe escribir
+     * @param skipped Mensajes omitidos desde el último permitido (para informarlos)
+     * @return false si la ventana actual ya agotó su cupo
+     */
+    bool allow(uint64_t& skipped);
+};
+
+/**
+ * @class Logger
+ * @brief Registro global del programa
+ * @details Antes de start() (o en herramientas que no lo inician) cada mensaje se
+ *          escribe en el momento. Con el hilo en marcha, si la cola se llena los
+ *          mensajes se descartan y se informa cuántos; los de nivel ERR nunca se
+ *          descartan: se escriben en el momento.
+ */
+class Logger {
+private:
+    std::atomic<int> threshold;         ///< Nivel máximo que se escribe
+    MpscQueue<LogEntry> queue;          ///< Mensajes pendientes de escribir
+    std::atomic<bool> running;          ///< true mientras el hilo escritor está activo
+    std::atomic<uint64_t> accepted;     ///< Mensajes encolados
+    std::atomic<uint64_t> dropped;      ///< Mensajes descartados por cola llena
+    uint64_t droppedReported;           ///< Descartes ya informados (solo el escritor)
+
+    std::thread writer;                 ///< Hilo que vacía la cola
+    std::mutex mtx;                     ///< Protege drained y stopping
+    std::condition_variable wakeCv;     ///< Despierta al escritor (flush o stop)
+    std::condition_variable drainedCv;  ///< Avisa a flush() que se escribió más
+    uint64_t drained;                   ///< Mensajes escritos por el hilo
+    bool stopping;                      ///< Solicita al escritor terminar
+    std::mutex outputMtx;               ///< Serializa las escrituras a la consola
+
+    Logger(const Logger&);            ///< No copiable
+    Logger& operator=(const Logger&); ///< No asignable
+
+    /**
+     * @brief Constructor privado (ver instance())
+     */
+    Logger();
+
+    /**
+     * @brief Bucle del hilo escritor
+     */
+    void writerLoop();
+
+    /**
+     * @brief Escribe todo lo que haya en la cola (solo el escritor)
+     * @return Mensajes escritos
+     */
+    uint64_t drainQueue();
+
+    /**
+     * @brief Escribe un mensaje en stdout o stderr según su nivel (requiere outputMtx)
+     * @param entry Mensaje
+     */
+    static void emit(const LogEntry& entry);
+
+public:
+    static const size_t QUEUE_ENTRIES = 4096;   ///< Mensajes que caben en la cola (~1 MiB)
+    static const int WRITE_INTERVAL_MS = 20;    ///< Espera máxima del escritor entre vaciados
+
+    /**
+     * @brief Obtiene el registro del programa
+     * @return Instancia única
+     */
+    static Logger& instance();
+
+    /**
+     * @brief Interpreta un nombre de nivel (error, warn, info, debug, trace)
+     * @param name Nombre
+     * @param level Nivel resultante
+     * @return false si el nombre no es un nivel
+     */
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+    /**
+     * @brief Fija el nivel máximo que se escribe
+     * @param level Nivel
+     */
+    void setLevel(LogLevel level);
+
+    /**
+     * @brief Indica si un nivel se escribe; conviene consultarlo antes de armar el texto
+     * @param level Nivel
+     * @return true si level no supera el configurado
+     */
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) <= threshold.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Registra un mensaje
+     * @param level Nivel
+     * @param text Texto sin salto de línea final
+     */
+    void write(LogLevel level, const std::string& text);
+
+    /**
+     * @brief Inicia el hilo escritor
+     */
+    void start();
+
+    /**
+     * @brief Espera a que se escriba todo lo encolado hasta ahora
+     * @details Llamar antes de escribir directamente en la consola (por ejemplo, una
+     *          pregunta al usuario) para no mezclar el orden de las líneas
+     */
+    void flush();
+
+    /**
+     * @brief Escribe lo pendiente y detiene el hilo escritor
+     */
+    void stop();
+
+    /**
+     * @brief Obtiene los mensajes descartados por cola llena
+     * @return Mensajes descartados desde el inicio
+     */
+    uint64_t getDropped() const;
+
+    /**
+     * @brief Destructor que detiene el hilo escritor
+     */
+    ~Logger();
+};
+
+#endif
@@ -0,0 +1,149 @@
+/**
+ * @file Lookup.cpp
+ * @brief Búsquedas en el archivo final ordenado usando su índice disperso
+ * @details Lee el índice (ARCHIVO.idx) que genera la Fase 2 y responde sin recorrer
+ *          toda la salida: una búsqueda binaria en memoria, un seek y a lo sumo un
+ *          intervalo de registros por consulta. Las respuestas usan el mismo formato que
+ *          las consultas en vivo (--query-socket).
+ *
+ * Uso: esort_lookup ARCHIVO [--index ARCHIVO.idx] stats | find V | rank V | range A B [LÍMITE]
+ */
+
+#include "SortedIndex.h"
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const size_t DEFAULT_RANGE_LIMIT = 20; ///< Valores listados por "range" sin límite
+
+/**
+ * @brief Muestra la forma de uso
+ */
+void printUsage() {
+    cerr << "Uso: esort_lookup ARCHIVO [--index ARCHIVO.idx] CONSULTA\n"
+         << "  stats               count, distinct, min, max y mean de la salida\n"
+         << "  find V              posición de la primera lectura igual a V\n"
+         << "  rank V              lecturas menores que V\n"
+         << "  range A B [LÍMITE]  lecturas en [A, B] (se listan hasta LÍMITE, 20 por defecto)\n";
+}
+
+/**
+ * @brief Interpreta un entero con signo
+ * @param text Texto a interpretar
+ * @param value Valor resultante
+ * @return false si el texto no es un entero
+ */
+bool parseNumber(const string& text, long long& value) {
+    char* end = nullptr;
+    value = strtoll(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0';
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    vector<string> args;
+    string indexFile;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--index" && i + 1 < argc) {
+            indexFile = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() < 2) {
+        printUsage();
+        return 1;
+    }
+
+    const string& command = args[1];
+    vector<long long> numbers;
+    for (size_t i = 2; i < args.size(); i++) {
+        long long value;
+        if (!parseNumber(args[i], value)) {
+            cerr << "Error: Número inválido " << args[i] << endl;
+            return 1;
+        }
+        numbers.push_back(value);
+    }
+
+    size_t needed = command == "stats" ? 0 : (command == "range" ? 2 : 1);
+    if (command != "stats" && command != "find" && command != "rank" && command != "range") {
+        cerr << "Error: Consulta desconocida " << command << endl;
+        printUsage();
+        return 1;
+    }
+    if (numbers.size() < needed || (command != "range" && numbers.size() > needed) ||
+        numbers.size() > 3) {
+        printUsage();
+        return 1;
+    }
+
+    SortedIndex index;
+    if (!index.open(args[0], indexFile)) {
+        return 1;
+    }
+    const SortedIndexHeader& header = index.getHeader();
+
+    if (command == "stats") {
+        cout << "count=" << header.count << " distinct=" << header.distinct;
+        if (header.count > 0) {
+            cout << " min=" << header.minKey << " max=" << header.maxKey
+                 << " mean=" << header.mean;
+        }
+        cout << " interval=" << header.interval << " entries=" << header.entries << endl;
+        return 0;
+    }
+
+    bool ok = true;
+    if (command == "rank") {
+        uint64_t rank;
+        ok = index.rank(numbers[0], rank);
+        if (ok) cout << "rank=" << rank << endl;
+    } else if (command == "find") {
+        // Fuera del rango de int no hay registros: así V + 1 no desborda
+        if (numbers[0] < numeric_limits<int>::min() || numbers[0] > numeric_limits<int>::max()) {
+            cout << "error=no encontrado" << endl;
+            return 2;
+        }
+        // Las repeticiones de V ocupan [rank(V), rank(V + 1))
+        uint64_t position;
+        uint64_t end;
+        ok = index.rank(numbers[0], position) && index.rank(numbers[0] + 1, end);
+        if (ok && end == position) {
+            cout << "error=no encontrado" << endl;
+            return 2;
+        }
+        if (ok) cout << "position=" << position << " count=" << end - position << endl;
+    } else {
+        size_t limit = DEFAULT_RANGE_LIMIT;
+        if (numbers.size() == 3) limit = numbers[2] < 0 ? 0 : static_cast<size_t>(numbers[2]);
+        uint64_t count;
+        vector<int> values;
+        ok = index.range(numbers[0], numbers[1], limit, count, values);
+        if (ok) {
+            cout << "count=" << count << " values=";
+            for (size_t i = 0; i < values.size(); i++) {
+                cout << (i > 0 ? "," : "") << values[i];
+            }
+            cout << endl;
+        }
+    }
+
+    if (!ok) {
+        cerr << "Error: No se pudo leer " << args[0] << endl;
+        return 1;
+    }
+    cerr << "(" << index.getSeeks() << " seeks)" << endl;
+    return 0;
+}
@@ -0,0 +1,10 @@
+/**
+ * @file LoserTree.cpp
+ * @brief Instancias de BasicLoserTree compiladas una sola vez
+ */
+
+#include "LoserTree.h"
+
+template class BasicLoserTree<int>;
+template class BasicLoserTree<TelemetryRecord, KeyLess<TimestampKey> >;
+template class BasicLoserTree<CountedValue, KeyLess<CountedValueKey> >;
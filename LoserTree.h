@@ -0,0 +1,188 @@
+/**
+ * @file LoserTree.h
+ * @brief Árbol de perdedores (torneo) para el K-Way Merge
+ * @details Selecciona el mínimo entre K fuentes con O(log K) comparaciones por dato
+ */
+
+#ifndef LOSERTREE_H
+#define LOSERTREE_H
+
+#include "Record.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class BasicLoserTree
+ * @brief Árbol de torneo que guarda en cada nodo interno la fuente perdedora
+ * @details Las hojas son las K fuentes; tree[0] guarda la fuente ganadora (mínimo según
+ *          Compare). Tras consumir el ganador solo se rejuega el camino hoja-raíz de esa
+ *          fuente. Los empates se resuelven por índice de fuente para que la fusión sea
+ *          estable.
+ */
+template<typename T, typename Compare = KeyLess<IdentityKey<T> > >
+class BasicLoserTree {
+private:
+    int k;                        ///< Número de fuentes (hojas)
+    std::vector<int> tree;        ///< tree[0] = ganador, tree[1..k-1] = perdedores
+    std::vector<T> keys;          ///< Registro actual de cada fuente
+    std::vector<char> exhausted;  ///< 1 si la fuente ya no tiene datos
+    uint64_t comparisons;         ///< Partidas jugadas (build + replays), para métricas
+    Compare less;                 ///< Comparador de registros
+
+    /**
+     * @brief Indica si la fuente a gana el partido contra la fuente b
+     * @param a Índice de la primera fuente
+     * @param b Índice de la segunda fuente
+     * @return true si a debe salir antes que b
+     */
+    bool beats(int a, int b) const {
+        if (exhausted[a]) return false;
+        if (exhausted[b]) return true;
+        if (less(keys[a], keys[b])) return true;
+        if (less(keys[b], keys[a])) return false;
+        return a < b;
+    }
+
+    /**
+     * @brief Rejuega el camino desde la hoja de una fuente hasta la raíz
+     * @param source Índice de la fuente cuya clave cambió
+     */
+    void replay(int source);
+
+public:
+    /**
+     * @brief Constructor
+     * @param sourceCount Número de fuentes K a fusionar
+     * @details Todas las fuentes comienzan agotadas hasta que se asigna su valor
+     */
+    BasicLoserTree(int sourceCount);
+
+    /**
+     * @brief Asigna el valor inicial de una fuente antes de build()
+     * @param source Índice de la fuente
+     * @param value Primer valor de la fuente
+     */
+    void setInitial(int source, const T& value);
+
+    /**
+     * @brief Construye el torneo completo con los valores iniciales
+     */
+    void build();
+
+    /**
+     * @brief Indica si todavía queda alguna fuente con datos
+     * @return true si el ganador actual no está agotado
+     */
+    bool hasWinner() const {
+        return k > 0 && !exhausted[tree[0]];
+    }
+
+    /**
+     * @brief Obtiene la fuente con el valor mínimo actual
+     * @return Índice de la fuente ganadora
+     */
+    int winner() const {
+        return tree[0];
+    }
+
+    /**
+     * @brief Obtiene el valor mínimo actual
+     * @return Valor de la fuente ganadora
+     */
+    const T& winnerValue() const {
+        return keys[tree[0]];
+    }
+
+    /**
+     * @brief Reemplaza el valor de la fuente ganadora por su siguiente dato
+     * @param value Siguiente valor leído de la fuente ganadora
+     */
+    void replaceWinner(const T& value);
+
+    /**
+     * @brief Marca la fuente ganadora como agotada
+     */
+    void exhaustWinner();
+
+    /**
+     * @brief Obtiene el número de comparaciones realizadas
+     * @return Partidas jugadas desde la construcción del árbol
+     */
+    uint64_t getComparisons() const {
+        return comparisons;
+    }
+};
+
+typedef BasicLoserTree<int> LoserTree;  ///< Torneo de enteros
+
+template<typename T, typename Compare>
+BasicLoserTree<T, Compare>::BasicLoserTree(int sourceCount)
+    : k(sourceCount), tree(sourceCount > 0 ? sourceCount : 1, 0),
+      keys(sourceCount), exhausted(sourceCount, 1), comparisons(0) {}
+
+template<typename T, typename Compare>
+void BasicLoserTree<T, Compare>::setInitial(int source, const T& value) {
+    keys[source] = value;
+    exhausted[source] = 0;
+}
+
+template<typename T, typename Compare>
+void BasicLoserTree<T, Compare>::build() {
+    if (k == 0) return;
+
+    // winners[i] = ganador del subárbol i; las hojas ocupan [k, 2k)
+    std::vector<int> winners(2 * k);
+    for (int i = 0; i < k; i++) {
+        winners[k + i] = i;
+    }
+
+    for (int node = k - 1; node >= 1; node--) {
+        int left = winners[2 * node];
+        int right = winners[2 * node + 1];
+        if (beats(left, right)) {
+            winners[node] = left;
+            tree[node] = right;
+        } else {
+            winners[node] = right;
+            tree[node] = left;
+        }
+    }
+
+    tree[0] = (k == 1) ? 0 : winners[1];
+    comparisons += k - 1;
+}
+
+template<typename T, typename Compare>
+void BasicLoserTree<T, Compare>::replay(int source) {
+    int current = source;
+    for (int node = (source + k) / 2; node > 0; node /= 2) {
+        comparisons++;
+        if (beats(tree[node], current)) {
+            int loser = current;
+            current = tree[node];
+            tree[node] = loser;
+        }
+    }
+    tree[0] = current;
+}
+
+template<typename T, typename Compare>
+void BasicLoserTree<T, Compare>::replaceWinner(const T& value) {
+    int source = tree[0];
+    keys[source] = value;
+    replay(source);
+}
+
+template<typename T, typename Compare>
+void BasicLoserTree<T, Compare>::exhaustWinner() {
+    int source = tree[0];
+    exhausted[source] = 1;
+    replay(source);
+}
+
+// Instancias compiladas en LoserTree.cpp
+extern template class BasicLoserTree<int>;
+extern template class BasicLoserTree<TelemetryRecord, KeyLess<TimestampKey> >;
+extern template class BasicLoserTree<CountedValue, KeyLess<CountedValueKey> >;
+
+#endif
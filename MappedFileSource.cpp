@@ -0,0 +1,100 @@
+/**
+ * @file MappedFileSource.cpp
+ * @brief Implementación de MappedRegion e instancias de BasicMappedFileSource
+ */
+
+#include "MappedFileSource.h"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// ============= IMPLEMENTACIÓN WINDOWS =============
+MappedRegion::MappedRegion()
+    : hFile(INVALID_HANDLE_VALUE), hMapping(NULL), base(nullptr), length(0) {}
+
+bool MappedRegion::open(const std::string& filename) {
+    hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0) {
+        return true;
+    }
+
+    hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL) {
+        std::cerr << "Error: No se pudo mapear el archivo " << filename << std::endl;
+        return false;
+    }
+
+    base = static_cast<const char*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (base == nullptr) {
+        std::cerr << "Error: No se pudo mapear el archivo " << filename << std::endl;
+        return false;
+    }
+    length = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedRegion::close() {
+    if (base != nullptr) UnmapViewOfFile(base);
+    if (hMapping != NULL) CloseHandle(hMapping);
+    if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+    hMapping = NULL;
+    hFile = INVALID_HANDLE_VALUE;
+    base = nullptr;
+    length = 0;
+}
+#else
+// ============= IMPLEMENTACIÓN LINUX =============
+MappedRegion::MappedRegion() : fd(-1), base(nullptr), length(0) {}
+
+bool MappedRegion::open(const std::string& filename) {
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "Error: No se pudo abrir el archivo " << filename << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        return true;
+    }
+
+    void* region = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (region == MAP_FAILED) {
+        std::cerr << "Error: No se pudo mapear el archivo " << filename << std::endl;
+        return false;
+    }
+    madvise(region, st.st_size, MADV_SEQUENTIAL);
+
+    base = static_cast<const char*>(region);
+    length = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedRegion::close() {
+    if (base != nullptr) munmap(const_cast<char*>(base), length);
+    if (fd != -1) ::close(fd);
+    fd = -1;
+    base = nullptr;
+    length = 0;
+}
+#endif
+
+MappedRegion::~MappedRegion() {
+    close();
+}
+
+template class BasicMappedFileSource<int>;
+template class BasicMappedFileSource<TelemetryRecord>;
+template class BasicMappedFileSource<CountedValue>;
@@ -0,0 +1,360 @@
+/**
+ * @file MappedFileSource.h
+ * @brief Fuente de datos que lee chunks mapeados en memoria
+ * @details Variante de FileSource basada en mmap (POSIX) o MapViewOfFile (Windows)
+ */
+
+#ifndef MAPPEDFILESOURCE_H
+#define MAPPEDFILESOURCE_H
+
+#include "DataSource.h"
+#include "ChunkFile.h"
+#include "Record.h"
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
+/**
+ * @class MappedRegion
+ * @brief Archivo completo mapeado en memoria de solo lectura
+ * @details Contiene el código dependiente de la plataforma, compartido por todas las
+ *          instancias de BasicMappedFileSource. Avisa al kernel que el acceso será
+ *          secuencial (madvise MADV_SEQUENTIAL / FILE_FLAG_SEQUENTIAL_SCAN).
+ */
+class MappedRegion {
+private:
+#ifdef _WIN32
+    HANDLE hFile;          ///< Handle del archivo en Windows
+    HANDLE hMapping;       ///< Handle del mapeo en Windows
+#else
+    int fd;                ///< File descriptor del archivo en Linux
+#endif
+    const char* base;      ///< Inicio de la región mapeada (nullptr si vacío o error)
+    size_t length;         ///< Tamaño de la región mapeada en bytes
+
+    MappedRegion(const MappedRegion&);            ///< No copiable
+    MappedRegion& operator=(const MappedRegion&); ///< No asignable
+
+public:
+    /**
+     * @brief Constructor de una región vacía
+     */
+    MappedRegion();
+
+    /**
+     * @brief Abre y mapea un archivo
+     * @param filename Nombre del archivo
+     * @return false si no se pudo abrir o mapear; un archivo vacío es válido (data() nulo)
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Libera el mapeo y cierra el archivo
+     */
+    void close();
+
+    /**
+     * @brief Inicio de los bytes mapeados
+     * @return Puntero al inicio (nullptr si el archivo está vacío o no se mapeó)
+     */
+    const char* data() const {
+        return base;
+    }
+
+    /**
+     * @brief Tamaño de la región mapeada
+     * @return Bytes mapeados
+     */
+    size_t size() const {
+        return length;
+    }
+
+    /**
+     * @brief Destructor que libera el mapeo
+     */
+    ~MappedRegion();
+};
+
+/**
+ * @class BasicMappedFileSource
+ * @brief Lee registros de un chunk mapeado en memoria, en formato texto, binario o delta
+ * @details Los chunks binarios se copian directamente de la región mapeada; los delta se
+ *          decodifican bloque a bloque desde el mapeo a un arreglo de DELTA_BLOCK_RECORDS;
+ *          los de texto se interpretan con RecordText<T>::parse sobre los bytes mapeados,
+ *          sin iostream ni locale.
+ */
+template<typename T>
+class BasicMappedFileSource : public BasicDataSource<T> {
+private:
+    MappedRegion region;   ///< Archivo mapeado
+    const char* cursor;    ///< Posición de lectura dentro de la región
+    const char* end;       ///< Fin de los datos dentro de la región
+    bool binary;           ///< true si el archivo es un chunk binario
+    bool delta;            ///< true si el chunk binario está en bloques delta
+    uint64_t remaining;    ///< Registros delta que faltan por decodificar
+    std::vector<T> decoded; ///< Bloque delta decodificado
+    size_t decodedPos;     ///< Siguiente registro a entregar de decoded
+    size_t decodedSize;    ///< Registros válidos en decoded
+    T nextValue;           ///< Siguiente valor ya leído (lectura anticipada)
+    bool hasNext;          ///< Indica si nextValue contiene un dato válido
+    ReadStatus status;     ///< Estado al agotarse los datos (fin normal o error)
+
+    BasicMappedFileSource(const BasicMappedFileSource&);            ///< No copiable
+    BasicMappedFileSource& operator=(const BasicMappedFileSource&); ///< No asignable
+
+    /**
+     * @brief Decodifica por anticipado el siguiente valor del mapeo
+     */
+    void advance();
+
+    /**
+     * @brief Decodifica el siguiente bloque delta del mapeo en decoded
+     * @return true si se decodificó al menos un registro
+     */
+    bool decodeBlock();
+
+    /**
+     * @brief Interpreta el siguiente registro de texto del mapeo
+     * @param value Registro leído
+     * @return false al final de los datos o ante un byte inválido (deja IO_ERROR)
+     */
+    bool parseText(T& value);
+
+public:
+    /**
+     * @brief Constructor que mapea un archivo en memoria
+     * @param filename Nombre del archivo a leer (ej: "chunk_XX.tmp")
+     * @details Detecta el formato por la firma del encabezado binario
+     */
+    BasicMappedFileSource(const std::string& filename);
+
+    /**
+     * @brief Devuelve el siguiente registro del archivo
+     * @return Siguiente valor leído
+     */
+    T getNext() override;
+
+    /**
+     * @brief Verifica si quedan datos en el archivo
+     * @return true si hay más datos disponibles
+     */
+    bool hasMoreData() override;
+
+    /**
+     * @brief Lee un lote de registros directamente de la región mapeada
+     * @param out Arreglo destino
+     * @param max Capacidad de out
+     * @return Registros leídos; en modo binario es un solo memcpy y en delta uno por bloque
+     */
+    size_t read(T* out, size_t max) override;
+
+    /**
+     * @brief Estado de la fuente
+     * @return OK, END_OF_DATA, o IO_ERROR si no se pudo abrir/mapear, el chunk está
+     *         truncado, su ancho de registro no es sizeof(T) o el texto tiene bytes que
+     *         no son dígitos, signo ni separadores
+     */
+    ReadStatus getStatus() const override;
+
+    /**
+     * @brief Interpreta un entero decimal desde un rango de bytes
+     * @param p Posición inicial; al volver apunta después del número
+     * @param end Fin del rango
+     * @param value Valor leído
+     * @return true si se encontró un número antes de end
+     * @details Salta separadores (espacios, comas, '\r', '\n') y acepta signo '-'; ver
+     *          parseDecimal para los bytes inválidos
+     */
+    static bool parseInt(const char*& p, const char* end, int& value) {
+        return parseDecimal(p, end, value);
+    }
+};
+
+typedef BasicMappedFileSource<int> MappedFileSource;  ///< Lector mapeado de chunks de enteros
+
+template<typename T>
+BasicMappedFileSource<T>::BasicMappedFileSource(const std::string& filename)
+    : cursor(nullptr), end(nullptr), binary(false), delta(false), remaining(0),
+      decodedPos(0), decodedSize(0), nextValue(), hasNext(false),
+      status(ReadStatus::END_OF_DATA) {
+    if (!region.open(filename)) {
+        status = ReadStatus::IO_ERROR;
+        return;
+    }
+
+    const char* base = region.data();
+    size_t length = region.size();
+    cursor = base;
+    end = base + length;
+
+    ChunkHeader header;
+    if (length >= sizeof(header)) {
+        std::memcpy(&header, base, sizeof(header));
+        if (isChunkHeader(header)) {
+            if (header.keyWidth != sizeof(T)) {
+                std::cerr << "Error: Ancho de registro no soportado en " << filename << std::endl;
+                status = ReadStatus::IO_ERROR;
+                cursor = end;
+                return;
+            }
+            binary = true;
+            cursor = base + sizeof(header);
+            if (isDeltaChunk(header)) {
+                // El tamaño de cada bloque varía: la truncación se detecta al decodificar
+                delta = true;
+                remaining = header.count;
+                decoded.resize(DELTA_BLOCK_RECORDS);
+                advance();
+                return;
+            }
+            size_t available = (length - sizeof(header)) / sizeof(T);
+            if (header.count < available) {
+                available = static_cast<size_t>(header.count);
+            } else if (header.count > available) {
+                std::cerr << "Error: Chunk binario truncado " << filename << std::endl;
+                status = ReadStatus::IO_ERROR;
+            }
+            end = cursor + available * sizeof(T);
+        }
+    }
+
+    advance();
+}
+
+template<typename T>
+bool BasicMappedFileSource<T>::decodeBlock() {
+    decodedPos = 0;
+    decodedSize = 0;
+    if (remaining == 0) {
+        return false;
+    }
+
+    DeltaBlockHeader header;
+    const uint8_t* payload = nullptr;
+    bool ok = static_cast<size_t>(end - cursor) >= sizeof(header);
+    if (ok) {
+        std::memcpy(&header, cursor, sizeof(header));
+        payload = reinterpret_cast<const uint8_t*>(cursor + sizeof(header));
+        ok = header.records <= remaining &&
+             header.bytes <= static_cast<size_t>(end - cursor) - sizeof(header) &&
+             decodeDeltaBlock(payload, header.bytes, header.records, decoded.data());
+    }
+    if (!ok) {
+        std::cerr << "Error: Chunk delta truncado o dañado" << std::endl;
+        remaining = 0;
+        status = ReadStatus::IO_ERROR;
+        return false;
+    }
+
+    cursor += sizeof(header) + header.bytes;
+    remaining -= header.records;
+    decodedSize = header.records;
+    return true;
+}
+
+template<typename T>
+void BasicMappedFileSource<T>::advance() {
+    if (delta) {
+        hasNext = decodedPos < decodedSize || decodeBlock();
+        if (hasNext) {
+            nextValue = decoded[decodedPos++];
+        }
+        return;
+    }
+
+    if (binary) {
+        if (cursor < end) {
+            std::memcpy(&nextValue, cursor, sizeof(T));
+            cursor += sizeof(T);
+            hasNext = true;
+        } else {
+            hasNext = false;
+        }
+        return;
+    }
+
+    hasNext = cursor != nullptr && parseText(nextValue);
+}
+
+template<typename T>
+bool BasicMappedFileSource<T>::parseText(T& value) {
+    if (RecordText<T>::parse(cursor, end, value)) {
+        return true;
+    }
+    if (cursor < end) {
+        // El texto se detuvo antes del fin: igual que BasicFileSource, no es un registro válido
+        std::cerr << "Error: Dato inválido en chunk de texto (byte " << (cursor - region.data())
+                  << ")" << std::endl;
+        status = ReadStatus::IO_ERROR;
+        cursor = end;
+    }
+    return false;
+}
+
+template<typename T>
+T BasicMappedFileSource<T>::getNext() {
+    if (!hasNext) {
+        return T();
+    }
+    T value = nextValue;
+    advance();
+    return value;
+}
+
+template<typename T>
+bool BasicMappedFileSource<T>::hasMoreData() {
+    return hasNext;
+}
+
+template<typename T>
+size_t BasicMappedFileSource<T>::read(T* out, size_t max) {
+    if (max == 0 || !hasNext) {
+        return 0;
+    }
+
+    size_t n = 0;
+    out[n++] = nextValue;
+
+    if (delta) {
+        // Bloques completos: un memcpy por bloque decodificado
+        while (n < max && (decodedPos < decodedSize || decodeBlock())) {
+            size_t available = decodedSize - decodedPos;
+            size_t take = available < max - n ? available : max - n;
+            std::memcpy(out + n, decoded.data() + decodedPos, take * sizeof(T));
+            decodedPos += take;
+            n += take;
+        }
+    } else if (binary) {
+        size_t available = static_cast<size_t>(end - cursor) / sizeof(T);
+        size_t take = available < max - n ? available : max - n;
+        std::memcpy(out + n, cursor, take * sizeof(T));
+        cursor += take * sizeof(T);
+        n += take;
+    } else {
+        T value;
+        while (n < max && parseText(value)) {
+            out[n++] = value;
+        }
+    }
+
+    advance();
+    return n;
+}
+
+template<typename T>
+ReadStatus BasicMappedFileSource<T>::getStatus() const {
+    return hasNext ? ReadStatus::OK : status;
+}
+
+// Instancias compiladas en MappedFileSource.cpp
+extern template class BasicMappedFileSource<int>;
+extern template class BasicMappedFileSource<TelemetryRecord>;
+extern template class BasicMappedFileSource<CountedValue>;
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * @file MergePlanner.cpp
+ * @brief Implementación de MergePlanner
+ */
+
+#include "MergePlanner.h"
+
+#ifndef _WIN32
+    #include <sys/resource.h>
+#endif
+
+MergePlanner::MergePlanner(int fanIn, const std::string& prefix, size_t blockSize,
+                           ChunkFormat format)
+    : maxFanIn(fanIn < 2 ? 2 : fanIn), tempPrefix(prefix), outputBlockSize(blockSize),
+      tempFormat(format == ChunkFormat::DELTA ? ChunkFormat::DELTA : ChunkFormat::BINARY),
+      passCount(0), recordsMerged(0), comparisons(0), outputRecords(0),
+      indexInterval(0), expandOutput(false), progress(nullptr) {}
+
+int MergePlanner::openFileLimit() {
+#ifdef _WIN32
+    return _getmaxstdio();
+#else
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+        return 1024;
+    }
+    return static_cast<int>(limit.rlim_cur);
+#endif
+}
+
+int MergePlanner::chooseFanIn(size_t memoryBudget) {
+    size_t outputBytes = 2 * BlockWriter::DEFAULT_BLOCK_SIZE;
+    size_t available = memoryBudget > outputBytes ? memoryBudget - outputBytes : 0;
+    size_t byMemory = available / PER_SOURCE_BYTES;
+
+    int byFiles = openFileLimit() - RESERVED_FDS;
+    size_t fanIn = byMemory < static_cast<size_t>(byFiles > 0 ? byFiles : 0)
+                       ? byMemory : static_cast<size_t>(byFiles > 0 ? byFiles : 0);
+
+    return fanIn < 2 ? 2 : static_cast<int>(fanIn);
+}
+
+void MergePlanner::setOutputIndex(uint32_t interval) {
+    indexInterval = interval;
+}
+
+void MergePlanner::setExpandOutput(bool expand) {
+    expandOutput = expand;
+}
+
+void MergePlanner::setProgress(ProgressReporter* reporter) {
+    progress = reporter;
+}
+
+int MergePlanner::countPasses(size_t runs) const {
+    // Mismos grupos que run(): cada pasada deja ceil(runs / maxFanIn) corridas
+    int passes = 1;
+    while (runs > static_cast<size_t>(maxFanIn)) {
+        runs = (runs + maxFanIn - 1) / maxFanIn;
+        passes++;
+    }
+    return passes;
+}
+
+int MergePlanner::getPassCount() const {
+    return passCount;
+}
+
+int MergePlanner::getFanIn() const {
+    return maxFanIn;
+}
+
+uint64_t MergePlanner::getRecordsMerged() const {
+    return recordsMerged;
+}
+
+uint64_t MergePlanner::getComparisons() const {
+    return comparisons;
+}
+
+uint64_t MergePlanner::getOutputRecords() const {
+    return outputRecords;
+}
@@ -0,0 +1,250 @@
+/**
+ * @file MergePlanner.h
+ * @brief Planificador de fusión en cascada con fan-in acotado
+ * @details Divide la Fase 2 en pasadas de MergeSort cuando hay más chunks que archivos
+ *          que se pueden mantener abiertos a la vez
+ */
+
+#ifndef MERGEPLANNER_H
+#define MERGEPLANNER_H
+
+#include "BlockWriter.h"
+#include "Logger.h"
+#include "MergeSort.h"
+#include "Record.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @class MergePlanner
+ * @brief Ejecuta el K-Way Merge en varias pasadas con un fan-in máximo
+ * @details Mientras queden más corridas que el fan-in, fusiona grupos de corridas en
+ *          archivos temporales binarios o delta (merge_pX_YY.tmp); la última pasada
+ *          escribe la salida final. Los temporales intermedios se eliminan al consumirse.
+ */
+class MergePlanner {
+private:
+    int maxFanIn;               ///< Máximo de corridas abiertas por MergeSort
+    std::string tempPrefix;     ///< Prefijo (directorio incluido) de los temporales
+    size_t outputBlockSize;     ///< Tamaño de bloque de escritura de cada pasada
+    ChunkFormat tempFormat;     ///< Formato de los temporales intermedios (BINARY o DELTA)
+    int passCount;              ///< Pasadas ejecutadas por el último run()
+    uint64_t recordsMerged;     ///< Registros escritos en todas las pasadas del último run()
+    uint64_t comparisons;       ///< Comparaciones del torneo en todas las pasadas
+    uint64_t outputRecords;     ///< Registros del archivo final del último run()
+    uint32_t indexInterval;     ///< Registros entre entradas del índice de la salida (0 = sin índice)
+    bool expandOutput;          ///< Expandir los registros agregados en el archivo final
+    ProgressReporter* progress; ///< Avance de todas las pasadas (opcional)
+
+public:
+    static const size_t PER_SOURCE_BYTES = 1 << 20; ///< Memoria estimada por corrida abierta
+    static const int RESERVED_FDS = 16;             ///< Descriptores reservados para el resto del programa
+
+    /**
+     * @brief Constructor
+     * @param fanIn Número máximo de corridas a fusionar a la vez (mínimo 2)
+     * @param prefix Prefijo para los archivos temporales intermedios
+     * @param blockSize Tamaño de bloque del BlockWriter de cada pasada
+     * @param format Formato de los temporales intermedios (TEXT se trata como BINARY)
+     */
+    MergePlanner(int fanIn, const std::string& prefix = "merge",
+                 size_t blockSize = BlockWriter::DEFAULT_BLOCK_SIZE,
+                 ChunkFormat format = ChunkFormat::BINARY);
+
+    /**
+     * @brief Calcula el fan-in a partir del presupuesto de memoria y del límite de archivos
+     * @param memoryBudget Bytes disponibles para la fusión
+     * @return Fan-in máximo (al menos 2)
+     * @details Cada corrida abierta reserva PER_SOURCE_BYTES de lectura y la salida usa
+     *          dos bloques; el resultado se limita por RLIMIT_NOFILE menos RESERVED_FDS
+     */
+    static int chooseFanIn(size_t memoryBudget);
+
+    /**
+     * @brief Obtiene el límite de archivos abiertos del proceso
+     * @return Límite blando de descriptores (o un valor conservador si no se conoce)
+     */
+    static int openFileLimit();
+
+    /**
+     * @brief Genera el índice disperso del archivo final (salida + ".idx")
+     * @param interval Registros entre entradas (0 = sin índice)
+     */
+    void setOutputIndex(uint32_t interval);
+
+    /**
+     * @brief Expande los registros agregados (CountedValue) en el archivo final
+     * @param expand true para una línea por repetición; false para "valor,repeticiones"
+     * @details Las pasadas intermedias siempre guardan pares
+     */
+    void setExpandOutput(bool expand);
+
+    /**
+     * @brief Informa el avance en registros leídos, sumando todas las pasadas
+     * @param reporter Avance compartido (nullptr = sin informe)
+     */
+    void setProgress(ProgressReporter* reporter);
+
+    /**
+     * @brief Calcula cuántas pasadas necesitará run() para un número de corridas
+     * @param runs Corridas de entrada
+     * @return Pasadas (1 si caben en un solo merge)
+     * @details Con el total de registros da el trabajo esperado para el avance: cada
+     *          pasada lee a lo sumo todos los registros una vez
+     */
+    int countPasses(size_t runs) const;
+
+    /**
+     * @brief Fusiona todas las corridas en el archivo de salida
+     * @param runs Nombres de las corridas ordenadas (no se eliminan)
+     * @param outputFile Nombre del archivo final ordenado
+     * @return true si todas las pasadas terminaron correctamente
+     * @details Se detiene en la primera pasada que falla: sus corridas de entrada no se
+     *          eliminan (solo sus salidas parciales) y no se intenta la pasada final.
+     *          T, KeyOf y Compare se pasan a cada BasicMergeSort; por defecto son enteros
+     */
+    template<typename T = int, typename KeyOf = IdentityKey<T>, typename Compare = KeyLess<KeyOf> >
+    bool run(const std::vector<std::string>& runs, const std::string& outputFile);
+
+    /**
+     * @brief Obtiene el número de pasadas del último run()
+     * @return Pasadas ejecutadas (1 si bastó un único merge)
+     */
+    int getPassCount() const;
+
+    /**
+     * @brief Obtiene el fan-in configurado
+     * @return Máximo de corridas por merge
+     */
+    int getFanIn() const;
+
+    /**
+     * @brief Obtiene los registros escritos en todas las pasadas
+     * @return Registros fusionados (intermedios incluidos) por el último run()
+     */
+    uint64_t getRecordsMerged() const;
+
+    /**
+     * @brief Obtiene las comparaciones del torneo en todas las pasadas
+     * @return Comparaciones realizadas por el último run()
+     */
+    uint64_t getComparisons() const;
+
+    /**
+     * @brief Obtiene los registros del archivo final
+     * @return Registros escritos por la última pasada del último run()
+     */
+    uint64_t getOutputRecords() const;
+};
+
+template<typename T, typename KeyOf, typename Compare>
+bool MergePlanner::run(const std::vector<std::string>& runs, const std::string& outputFile) {
+    std::vector<std::string> current = runs;
+    std::vector<bool> isTemp(current.size(), false);
+    passCount = 0;
+    recordsMerged = 0;
+    comparisons = 0;
+    bool ok = true;
+
+    while (current.size() > static_cast<size_t>(maxFanIn)) {
+        passCount++;
+        std::vector<std::string> next;
+        std::vector<bool> nextIsTemp;
+        std::vector<std::string> created;   // Corridas escritas en esta pasada
+        std::vector<std::string> consumed;  // Temporales fusionados en esta pasada
+
+        // Grupos de maxFanIn corridas; un grupo de una sola corrida pasa tal cual
+        for (size_t start = 0; start < current.size(); start += maxFanIn) {
+            size_t stop = start + maxFanIn < current.size() ? start + maxFanIn : current.size();
+
+            if (stop - start == 1) {
+                next.push_back(current[start]);
+                nextIsTemp.push_back(isTemp[start]);
+                continue;
+            }
+
+            std::vector<std::string> group(current.begin() + start, current.begin() + stop);
+            for (size_t i = start; i < stop; i++) {
+                if (isTemp[i]) {
+                    consumed.push_back(current[i]);
+                }
+            }
+            std::string runName = tempPrefix + "_p" + std::to_string(passCount) + "_" +
+                                  std::to_string(next.size() + 1) + ".tmp";
+
+            Logger& log = Logger::instance();
+            if (log.enabled(LogLevel::INFO)) {
+                std::ostringstream message;
+                message << "Pasada " << passCount << ": fusionando " << group.size()
+                        << " corridas en " << runName;
+                log.write(LogLevel::INFO, message.str());
+            }
+            {
+                BasicMergeSort<T, KeyOf, Compare> merger(group, runName, outputBlockSize,
+                                                         tempFormat);
+                merger.setProgress(progress);
+                ok = merger.merge();
+                recordsMerged += merger.getRecordCount();
+                comparisons += merger.getComparisons();
+            }
+
+            next.push_back(runName);
+            nextIsTemp.push_back(true);
+            created.push_back(runName);
+            if (!ok) {
+                break;
+            }
+        }
+
+        if (!ok) {
+            // Las entradas de la pasada quedan intactas; solo sobran sus salidas parciales
+            for (size_t i = 0; i < created.size(); i++) {
+                std::remove(created[i].c_str());
+            }
+            std::cerr << "Error: Falló la pasada " << passCount
+                      << "; se conservan sus corridas de entrada" << std::endl;
+            outputRecords = 0;
+            return false;
+        }
+
+        for (size_t i = 0; i < consumed.size(); i++) {
+            std::remove(consumed[i].c_str());
+        }
+
+        current.swap(next);
+        isTemp.swap(nextIsTemp);
+    }
+
+    passCount++;
+    {
+        BasicMergeSort<T, KeyOf, Compare> merger(current, outputFile, outputBlockSize);
+        merger.setIndex(outputFile + SORTED_INDEX_SUFFIX, indexInterval);
+        merger.setExpandOutput(expandOutput);
+        merger.setProgress(progress);
+        ok = merger.merge();
+        outputRecords = merger.getRecordCount();
+        recordsMerged += outputRecords;
+        comparisons += merger.getComparisons();
+    }
+
+    if (!ok) {
+        std::cerr << "Error: Falló la pasada final; se conservan sus corridas de entrada"
+                  << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < current.size(); i++) {
+        if (isTemp[i]) {
+            std::remove(current[i].c_str());
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -8,18 +8,26 @@
 #define MERGESORT_H
 
 #include "DataSource.h"
-#include "FileSource.h"
+#include "MappedFileSource.h"
+#include "LoserTree.h"
+#include "BlockWriter.h"
+#include "ChunkFile.h"
+#include "Record.h"
+#include "SortedIndex.h"
+#include "ProgressReporter.h"
+#include <cstdio>
+#include <iostream>
 #include <vector>
 #include <string>
-#include <fstream>
 
 /**
- * @struct MergeElement
+ * @struct BasicMergeElement
  * @brief Elemento usado durante el proceso de merge
- * @details Almacena un valor y el índice de su fuente
+ * @details Almacena un registro y el índice de su fuente
  */
-struct MergeElement {
-    int value;          ///< Valor del elemento
+template<typename T>
+struct BasicMergeElement {
+    T value;            ///< Valor del elemento
     int sourceIndex;    ///< Índice de la fuente de datos
 
     /**
@@ -27,47 +35,327 @@ struct MergeElement {
      * @param val Valor a almacenar
      * @param idx Índice de la fuente
      */
-    MergeElement(int val, int idx) : value(val), sourceIndex(idx) {}
+    BasicMergeElement(const T& val, int idx) : value(val), sourceIndex(idx) {}
 };
 
+typedef BasicMergeElement<int> MergeElement;  ///< Elemento de merge de enteros
+
 /**
- * @class MergeSort
+ * @class BasicMergeSort
  * @brief Implementa K-Way Merge para ordenamiento externo
- * @details Fusiona K archivos ordenados usando un heap manual
+ * @details Fusiona K archivos ordenados usando un árbol de perdedores (LoserTree),
+ *          de modo que cada dato de salida cuesta O(log K) comparaciones. Las corridas
+ *          deben estar ordenadas con el mismo KeyOf/Compare; el encabezado de la salida
+ *          binaria guarda las claves (KeyOf) del primer y último registro.
  */
-class MergeSort {
+template<typename T, typename KeyOf = IdentityKey<T>, typename Compare = KeyLess<KeyOf> >
+class BasicMergeSort {
 private:
-    std::vector<FileSource*> sources;  ///< Vector de fuentes de datos (archivos)
-    std::ofstream outputFile;          ///< Archivo de salida
+    std::vector<BasicDataSource<T>*> sources; ///< Vector de fuentes de datos (chunks mapeados)
+    BlockWriter outputFile;            ///< Archivo de salida escrito por bloques
+    std::string outputName;            ///< Nombre del archivo de salida
+    ChunkFormat outputFormat;          ///< Formato de la salida (texto, chunk binario o delta)
+    DeltaBlockEncoder<T> encoder;      ///< Bloques de la salida en formato DELTA
+    SortedIndexWriter index;           ///< Índice disperso de la salida de texto (opcional)
+    std::string indexName;             ///< Archivo del índice (vacío = sin índice)
+    uint32_t indexInterval;            ///< Registros entre entradas del índice
+    bool expandOutput;                 ///< Escribir cada repetición de un registro agregado
+    int64_t firstKey;                  ///< Clave del primer registro escrito
+    int64_t lastKey;                   ///< Clave del último registro escrito
+    uint64_t recordCount;              ///< Registros escritos por merge()
+    uint64_t comparisons;              ///< Comparaciones del torneo en merge()
+    ProgressReporter* progress;        ///< Avance en registros de entrada (opcional)
+    std::vector<T> batches;            ///< Lote leído de cada fuente (BATCH_RECORDS por fuente)
+    std::vector<size_t> batchPos;      ///< Siguiente dato a entregar del lote de cada fuente
+    std::vector<size_t> batchSize;     ///< Datos válidos en el lote de cada fuente
+    bool sourceFailed;                 ///< true si alguna fuente terminó con error
+
+    static const size_t BATCH_RECORDS = 4096; ///< Datos por lectura de cada fuente
+    static const uint64_t PROGRESS_STEP = 65536; ///< Registros entre sumas al avance
+
+    BasicMergeSort(const BasicMergeSort&);            ///< No copiable (posee las fuentes)
+    BasicMergeSort& operator=(const BasicMergeSort&); ///< No asignable (posee las fuentes)
+
+    /**
+     * @brief Obtiene el siguiente dato de una fuente, releyendo su lote si se agotó
+     * @param source Índice de la fuente
+     * @param value Dato obtenido
+     * @return false si la fuente terminó
+     */
+    bool nextFrom(int source, T& value);
 
     /**
-     * @brief Encuentra el índice del elemento mínimo entre las fuentes activas
-     * @param elements Vector de elementos actuales de cada fuente
-     * @param active Vector indicando qué fuentes aún tienen datos
-     * @return Índice de la fuente con el elemento mínimo
+     * @brief Escribe un registro en la salida en el formato configurado
+     * @param record Registro a escribir
+     * @param indexed true si se anota en el índice disperso
+     * @param expanding true si un registro agregado se escribe repetición por repetición
      */
-    int findMinIndex(const std::vector<int>& elements, const std::vector<bool>& active);
+    void writeRecord(const T& record, bool indexed, bool expanding);
 
 public:
     /**
      * @brief Constructor
      * @param chunkFiles Vector con nombres de archivos a fusionar
      * @param outputFileName Nombre del archivo de salida
-     * @details Abre todos los archivos fuente y el archivo de salida
+     * @param outputBlockSize Tamaño en bytes de cada bloque de escritura de la salida
+     * @param format Formato de la salida; BINARY y DELTA producen un chunk reutilizable
+     *               como entrada
+     * @details Mapea en memoria todos los archivos fuente y abre el archivo de salida
      */
-    MergeSort(const std::vector<std::string>& chunkFiles, const std::string& outputFileName);
+    BasicMergeSort(const std::vector<std::string>& chunkFiles, const std::string& outputFileName,
+                   size_t outputBlockSize = BlockWriter::DEFAULT_BLOCK_SIZE,
+                   ChunkFormat format = ChunkFormat::TEXT);
 
     /**
      * @brief Ejecuta el algoritmo K-Way Merge
-     * @details Lee el primer elemento de cada fuente, selecciona el mínimo,
-     *          lo escribe en el archivo de salida, y avanza esa fuente
+     * @details Lee el primer elemento de cada fuente y construye el torneo;
+     *          escribe el ganador, avanza esa fuente y rejuega solo su camino. Con
+     *          registros agregados (RecordAggregate<T>::ENABLED) los ganadores de igual
+     *          clave, que salen seguidos del torneo, se combinan en uno antes de escribirse
+     * @return true si la salida se escribió completa
+     */
+    bool merge();
+
+    /**
+     * @brief Genera un índice disperso de la salida mientras se escribe
+     * @param indexFile Archivo del índice (ej: "output.sorted.txt.idx")
+     * @param interval Registros entre entradas del índice (0 = sin índice)
+     * @details Solo para salidas de texto; llamar antes de merge()
+     */
+    void setIndex(const std::string& indexFile, uint32_t interval);
+
+    /**
+     * @brief Expande los registros agregados al escribir la salida de texto
+     * @param expand true para escribir una línea por repetición en lugar de "valor,repeticiones"
+     * @details Sin efecto si T no es agregado; llamar antes de merge()
+     */
+    void setExpandOutput(bool expand);
+
+    /**
+     * @brief Informa el avance de merge() en registros leídos de las corridas
+     * @param reporter Avance compartido (nullptr = sin informe); debe vivir hasta merge()
+     * @details Se suma cada PROGRESS_STEP registros, no en cada uno
      */
-    void merge();
+    void setProgress(ProgressReporter* reporter);
+
+    /**
+     * @brief Obtiene el número de registros escritos por merge()
+     * @return Registros fusionados
+     */
+    uint64_t getRecordCount() const;
+
+    /**
+     * @brief Obtiene las comparaciones del árbol de perdedores en merge()
+     * @return Comparaciones realizadas
+     */
+    uint64_t getComparisons() const;
 
     /**
      * @brief Destructor que libera recursos
      */
-    ~MergeSort();
+    ~BasicMergeSort();
 };
 
-#endif
\ No newline at end of file
+typedef BasicMergeSort<int> MergeSort;  ///< Fusión de chunks de enteros
+
+template<typename T, typename KeyOf, typename Compare>
+BasicMergeSort<T, KeyOf, Compare>::BasicMergeSort(const std::vector<std::string>& chunkFiles,
+                                                  const std::string& outputFileName,
+                                                  size_t outputBlockSize, ChunkFormat format)
+    : outputFile(outputFileName, outputBlockSize), outputName(outputFileName),
+      outputFormat(format), indexInterval(0), expandOutput(false), firstKey(0), lastKey(0),
+      recordCount(0), comparisons(0), progress(nullptr), sourceFailed(false) {
+    for (const auto& filename : chunkFiles) {
+        sources.push_back(new BasicMappedFileSource<T>(filename));
+    }
+    batches.resize(sources.size() * BATCH_RECORDS);
+    batchPos.assign(sources.size(), 0);
+    batchSize.assign(sources.size(), 0);
+
+    if (!outputFile.isOpen()) {
+        std::cerr << "Error: No se pudo crear el archivo de salida "
+                  << outputFileName << std::endl;
+    }
+}
+
+template<typename T, typename KeyOf, typename Compare>
+bool BasicMergeSort<T, KeyOf, Compare>::nextFrom(int source, T& value) {
+    if (batchPos[source] == batchSize[source]) {
+        T* batch = &batches[source * BATCH_RECORDS];
+        batchSize[source] = sources[source]->read(batch, BATCH_RECORDS);
+        batchPos[source] = 0;
+        if (batchSize[source] == 0) {
+            if (sources[source]->getStatus() == ReadStatus::IO_ERROR) {
+                sourceFailed = true;
+            }
+            return false;
+        }
+    }
+    value = batches[source * BATCH_RECORDS + batchPos[source]++];
+    return true;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+bool BasicMergeSort<T, KeyOf, Compare>::merge() {
+    if (!outputFile.isOpen()) {
+        return false;
+    }
+
+    int K = sources.size();
+    BasicLoserTree<T, Compare> tree(K);
+    bool binary = (outputFormat == ChunkFormat::BINARY);
+    bool delta = (outputFormat == ChunkFormat::DELTA);
+
+    ChunkHeader header;
+    if (binary || delta) {
+        // Encabezado provisional; count/min/max se completan al terminar
+        makeChunkHeader(header, 0, 0, 0, sizeof(T), outputFormat);
+        outputFile.write(&header, sizeof(header));
+    }
+
+    bool expanding = expandOutput && !binary && !delta && RecordAggregate<T>::ENABLED;
+    bool indexed = !binary && !delta && !indexName.empty();
+    if (!indexName.empty()) {
+        // Un índice de una ejecución anterior ya no corresponde a esta salida
+        std::remove(indexName.c_str());
+        if (!indexed) {
+            std::cerr << "Advertencia: El índice solo se genera para salidas de texto" << std::endl;
+        }
+        index.reset(indexInterval, expanding ? RecordAggregate<T>::EXPANDED_WIDTH
+                                             : static_cast<uint16_t>(sizeof(T)));
+    }
+
+    T value;
+    for (int i = 0; i < K; i++) {
+        if (nextFrom(i, value)) {
+            tree.setInitial(i, value);
+        }
+    }
+    tree.build();
+
+    T pending = T();
+    bool hasPending = false;
+    uint64_t unreported = 0;
+    while (tree.hasWinner()) {
+        int minIndex = tree.winner();
+        value = tree.winnerValue();
+        if (progress != nullptr && ++unreported == PROGRESS_STEP) {
+            progress->add(unreported);
+            unreported = 0;
+        }
+
+        T next;
+        if (nextFrom(minIndex, next)) {
+            tree.replaceWinner(next);
+        } else {
+            tree.exhaustWinner();
+        }
+
+        if (!RecordAggregate<T>::ENABLED) {
+            writeRecord(value, indexed, expanding);
+        } else if (!hasPending || !RecordAggregate<T>::combine(pending, value)) {
+            // Clave nueva: el acumulado anterior ya recibió todas sus repeticiones
+            if (hasPending) writeRecord(pending, indexed, expanding);
+            pending = value;
+            hasPending = true;
+        }
+    }
+    if (hasPending) {
+        writeRecord(pending, indexed, expanding);
+    }
+    if (progress != nullptr) {
+        progress->add(unreported);
+    }
+    comparisons = tree.getComparisons();
+    if (delta) {
+        encoder.flush(outputFile);
+    }
+
+    uint64_t outputBytes = outputFile.bytesWritten();
+    if (!outputFile.close()) {
+        std::cerr << "Error: Falló la escritura del archivo de salida" << std::endl;
+        return false;
+    }
+    if (sourceFailed) {
+        std::cerr << "Error: Alguna corrida no se pudo leer completa; la salida está incompleta"
+                  << std::endl;
+        return false;
+    }
+
+    if (binary || delta) {
+        makeChunkHeader(header, recordCount, firstKey, lastKey, sizeof(T), outputFormat);
+        return patchChunkHeader(outputName, header);
+    }
+    if (indexed && !index.write(indexName, outputBytes)) {
+        // La salida está completa; solo las búsquedas tendrán que leerla entera
+        std::cerr << "Advertencia: Se omite el índice de " << outputName << std::endl;
+    }
+    return true;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+inline void BasicMergeSort<T, KeyOf, Compare>::writeRecord(const T& record, bool indexed,
+                                                           bool expanding) {
+    int64_t key = static_cast<int64_t>(KeyOf::key(record));
+    uint64_t written = 1;
+    if (outputFormat == ChunkFormat::DELTA) {
+        encoder.append(outputFile, record);
+    } else if (outputFormat == ChunkFormat::BINARY) {
+        outputFile.write(&record, sizeof(record));
+    } else if (expanding) {
+        written = RecordAggregate<T>::count(record);
+        for (uint64_t i = 0; i < written; i++) {
+            if (indexed) index.add(key, outputFile.bytesWritten());
+            RecordAggregate<T>::writeExpanded(outputFile, record);
+        }
+    } else {
+        if (indexed) index.add(key, outputFile.bytesWritten());
+        RecordText<T>::write(outputFile, record);
+    }
+    if (recordCount == 0) firstKey = key;
+    lastKey = key;
+    recordCount += written;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicMergeSort<T, KeyOf, Compare>::setIndex(const std::string& indexFile, uint32_t interval) {
+    indexName = interval > 0 ? indexFile : std::string();
+    indexInterval = interval;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicMergeSort<T, KeyOf, Compare>::setExpandOutput(bool expand) {
+    expandOutput = expand;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+void BasicMergeSort<T, KeyOf, Compare>::setProgress(ProgressReporter* reporter) {
+    progress = reporter;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+uint64_t BasicMergeSort<T, KeyOf, Compare>::getRecordCount() const {
+    return recordCount;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+uint64_t BasicMergeSort<T, KeyOf, Compare>::getComparisons() const {
+    return comparisons;
+}
+
+template<typename T, typename KeyOf, typename Compare>
+BasicMergeSort<T, KeyOf, Compare>::~BasicMergeSort() {
+    for (auto source : sources) {
+        delete source;
+    }
+    sources.clear();
+
+    outputFile.close();
+}
+
+// Instancias compiladas en MergeSort.cpp
+extern template class BasicMergeSort<int>;
+extern template class BasicMergeSort<TelemetryRecord, TimestampKey>;
+extern template class BasicMergeSort<CountedValue, CountedValueKey>;
+
+#endif
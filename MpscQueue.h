@@ -0,0 +1,114 @@
+/**
+ * @file MpscQueue.h
+ * @brief Cola circular sin bloqueos para varios productores y un consumidor
+ * @details Usada por Logger: cualquier hilo encola mensajes y un único hilo los escribe
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class MpscQueue
+ * @brief Cola acotada lock-free de varios productores y un solo consumidor
+ * @tparam T Tipo de los elementos (copiable)
+ * @details Cada celda guarda un número de secuencia: vale la posición cuando está libre
+ *          para esa vuelta, posición + 1 cuando tiene un elemento publicado. Un productor
+ *          reserva la posición con un CAS sobre tail, copia el elemento y lo publica con
+ *          release; el consumidor lee con acquire y devuelve la celda sumando la capacidad.
+ *          Un productor nunca espera a otro: si la cola está llena tryPush devuelve false.
+ */
+template <typename T>
+class MpscQueue {
+private:
+    /**
+     * @struct Cell
+     * @brief Elemento de la cola con su número de secuencia
+     */
+    struct Cell {
+        std::atomic<size_t> sequence;  ///< Estado de la celda (ver la clase)
+        T value;                       ///< Elemento
+    };
+
+    Cell* cells;                   ///< Arreglo circular de celdas
+    size_t mask;                   ///< capacidad - 1 (capacidad potencia de dos)
+    char padHead[64];              ///< Separa head de los campos de solo lectura (false sharing)
+    size_t head;                   ///< Siguiente posición a leer (solo el consumidor)
+    char padTail[64];              ///< Separa head y tail en líneas de caché distintas
+    std::atomic<size_t> tail;      ///< Siguiente posición a reservar (productores)
+
+    MpscQueue(const MpscQueue&);            ///< No copiable
+    MpscQueue& operator=(const MpscQueue&); ///< No asignable
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Número mínimo de elementos que debe poder contener la cola
+     */
+    explicit MpscQueue(size_t capacity) : cells(nullptr), mask(0), head(0), tail(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells = new Cell[size];
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = size - 1;
+    }
+
+    /**
+     * @brief Intenta encolar un elemento (cualquier hilo)
+     * @param value Elemento a encolar
+     * @return false si la cola está llena
+     */
+    bool tryPush(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[t & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            if (sequence == t) {
+                // Libre en esta vuelta: se reserva si ningún otro productor la tomó antes
+                if (tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (sequence < t) {
+                // Todavía ocupada por la vuelta anterior: la cola está llena
+                return false;
+            } else {
+                t = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Intenta desencolar un elemento (solo el consumidor)
+     * @param value Destino del elemento desencolado
+     * @return false si la cola está vacía o el siguiente elemento aún no se publicó
+     */
+    bool tryPop(T& value) {
+        Cell* cell = &cells[head & mask];
+        if (cell->sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        value = cell->value;
+        cell->sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+    /**
+     * @brief Destructor que libera el arreglo de celdas
+     */
+    ~MpscQueue() {
+        delete[] cells;
+    }
+};
+
+#endif
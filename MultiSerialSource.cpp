@@ -0,0 +1,157 @@
+/**
+ * @file MultiSerialSource.cpp
+ * @brief Implementación de MultiSerialSource
+ */
+
+#include "MultiSerialSource.h"
+
+MultiSerialSource::MultiSerialSource(const std::vector<std::string>& portNames, int baudRate,
+                                     int idleTimeout, SerialProtocol protocol)
+    : nextPort(0), stopping(false), discarding(false) {
+    for (size_t i = 0; i < portNames.size(); i++) {
+        SerialSource* source = new SerialSource(portNames[i], baudRate, idleTimeout, protocol);
+        ports.push_back(new Port(source, QUEUE_CAPACITY));
+    }
+
+    for (size_t i = 0; i < ports.size(); i++) {
+        ports[i]->reader = std::thread(&MultiSerialSource::readerLoop, this, ports[i]);
+    }
+}
+
+void MultiSerialSource::readerLoop(Port* port) {
+    int batch[READ_BATCH];
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        size_t count = port->source->read(batch, READ_BATCH);
+        if (count == 0) {
+            break;
+        }
+
+        size_t pushed = 0;
+        int spins = 0;
+        // Un lote ya leído se entrega aunque se haya pedido detener: salió del puerto
+        while (pushed < count && !discarding.load(std::memory_order_relaxed)) {
+            size_t n = port->queue.tryPushBatch(batch + pushed, count - pushed);
+            if (n == 0) {
+                backoff(spins);
+                continue;
+            }
+            pushed += n;
+            spins = 0;
+        }
+        port->readings.fetch_add(pushed, std::memory_order_relaxed);
+    }
+    port->finished.store(true, std::memory_order_release);
+}
+
+int MultiSerialSource::getNext() {
+    int spins = 0;
+    while (true) {
+        bool anyActive = false;
+        for (size_t i = 0; i < ports.size(); i++) {
+            size_t p = (nextPort + i) % ports.size();
+            // Leer finished antes de la cola: si ya terminó, lo que quede en la cola es todo
+            bool finished = ports[p]->finished.load(std::memory_order_acquire);
+            int value;
+            if (ports[p]->queue.tryPop(value)) {
+                nextPort = (p + 1) % ports.size();
+                return value;
+            }
+            if (!finished) anyActive = true;
+        }
+        if (!anyActive) {
+            return 0;
+        }
+        backoff(spins);
+    }
+}
+
+size_t MultiSerialSource::read(int* out, size_t max) {
+    int spins = 0;
+    while (max > 0) {
+        size_t n = 0;
+        bool anyActive = false;
+        for (size_t i = 0; i < ports.size() && n < max; i++) {
+            size_t p = (nextPort + i) % ports.size();
+            // Leer finished antes de la cola: si ya terminó, lo que quede en la cola es todo
+            bool finished = ports[p]->finished.load(std::memory_order_acquire);
+            n += ports[p]->queue.tryPopBatch(out + n, max - n);
+            if (!finished) anyActive = true;
+        }
+        nextPort = (nextPort + 1) % (ports.empty() ? 1 : ports.size());
+
+        if (n > 0) {
+            return n;
+        }
+        if (!anyActive) {
+            return 0;
+        }
+        backoff(spins);
+    }
+    return 0;
+}
+
+ReadStatus MultiSerialSource::getStatus() const {
+    bool anyFailed = false;
+    for (size_t i = 0; i < ports.size(); i++) {
+        if (!ports[i]->finished.load(std::memory_order_acquire) || !ports[i]->queue.empty()) {
+            return ReadStatus::OK;
+        }
+        // Un puerto que no abrió o que falló deja datos sin capturar: no es un fin limpio
+        if (ports[i]->source->getStatus() == ReadStatus::IO_ERROR) {
+            anyFailed = true;
+        }
+    }
+    return anyFailed ? ReadStatus::IO_ERROR : ReadStatus::END_OF_DATA;
+}
+
+bool MultiSerialSource::hasMoreData() {
+    for (size_t i = 0; i < ports.size(); i++) {
+        if (!ports[i]->finished.load(std::memory_order_acquire) || !ports[i]->queue.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MultiSerialSource::getPortCount() const {
+    return ports.size();
+}
+
+uint64_t MultiSerialSource::getReadings(size_t index) const {
+    return ports[index]->readings.load(std::memory_order_relaxed);
+}
+
+const SerialSource& MultiSerialSource::getPort(size_t index) const {
+    return *ports[index]->source;
+}
+
+SourceStats MultiSerialSource::getStats() const {
+    SourceStats total;
+    for (size_t i = 0; i < ports.size(); i++) {
+        SourceStats port = ports[i]->source->getStats();
+        total.records += port.records;
+        total.bytes += port.bytes;
+        total.timeouts += port.timeouts;
+        total.invalidLines += port.invalidLines;
+        total.corruptFrames += port.corruptFrames;
+    }
+    return total;
+}
+
+bool MultiSerialSource::stopAcquisition() {
+    stopping.store(true);
+    return true;
+}
+
+MultiSerialSource::~MultiSerialSource() {
+    stopping.store(true);
+    discarding.store(true);
+    for (size_t i = 0; i < ports.size(); i++) {
+        if (ports[i]->reader.joinable()) {
+            ports[i]->reader.join();
+        }
+        delete ports[i]->source;
+        delete ports[i];
+    }
+}
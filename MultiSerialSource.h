@@ -0,0 +1,141 @@
+/**
+ * @file MultiSerialSource.h
+ * @brief Fuente de datos que combina varios puertos seriales en un solo flujo
+ * @details Permite que un único trabajo de ordenamiento ingiera de N dispositivos a la vez
+ */
+
+#ifndef MULTISERIALSOURCE_H
+#define MULTISERIALSOURCE_H
+
+#include "DataSource.h"
+#include "SerialSource.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class MultiSerialSource
+ * @brief Lee N SerialSource en paralelo, un hilo lector por puerto
+ * @details Cada lector deja sus lecturas en su propia SpscQueue (él es el único productor
+ *          y el hilo de adquisición el único consumidor). getNext() recorre las colas en
+ *          round-robin, de modo que todos los puertos alimentan el mismo generador de corridas.
+ */
+class MultiSerialSource : public DataSource {
+private:
+    /**
+     * @struct Port
+     * @brief Estado de un puerto y su hilo lector
+     */
+    struct Port {
+        SerialSource* source;          ///< Puerto serial abierto
+        SpscQueue<int> queue;          ///< Lecturas pendientes de entregar
+        std::atomic<bool> finished;    ///< true cuando el lector terminó
+        std::atomic<uint64_t> readings; ///< Lecturas recibidas por este puerto
+        std::thread reader;            ///< Hilo lector del puerto
+
+        Port(SerialSource* s, size_t capacity)
+            : source(s), queue(capacity), finished(false), readings(0) {}
+    };
+
+    static const size_t QUEUE_CAPACITY = 1 << 16; ///< Lecturas en cola por puerto
+    static const size_t READ_BATCH = 1024;        ///< Lecturas por lote del hilo lector
+
+    std::vector<Port*> ports;       ///< Puertos abiertos
+    size_t nextPort;                ///< Puerto donde empieza la siguiente búsqueda
+    std::atomic<bool> stopping;     ///< Solicita a los lectores no leer más del puerto
+    std::atomic<bool> discarding;   ///< Los lectores no esperan lugar en la cola (destructor)
+
+    MultiSerialSource(const MultiSerialSource&);            ///< No copiable
+    MultiSerialSource& operator=(const MultiSerialSource&); ///< No asignable
+
+    /**
+     * @brief Bucle del hilo lector de un puerto
+     * @param port Puerto a leer
+     */
+    void readerLoop(Port* port);
+
+public:
+    /**
+     * @brief Constructor que abre todos los puertos y arranca un lector por puerto
+     * @param portNames Nombres de los puertos (ej: "/dev/ttyUSB0", "/dev/ttyACM1")
+     * @param baudRate Velocidad de comunicación de todos los puertos
+     * @param idleTimeout Milisegundos sin datos antes de dar un puerto por terminado
+     * @param protocol Formato de los datos de los dispositivos
+     */
+    MultiSerialSource(const std::vector<std::string>& portNames, int baudRate = 9600,
+                      int idleTimeout = 2000, SerialProtocol protocol = SerialProtocol::TEXT);
+
+    /**
+     * @brief Devuelve la siguiente lectura disponible de cualquier puerto
+     * @return int Siguiente valor (0 si todos los puertos terminaron)
+     * @details Espera solo si ninguna cola tiene datos y algún lector sigue activo
+     */
+    int getNext() override;
+
+    /**
+     * @brief Verifica si algún puerto puede entregar más datos
+     * @return true si hay lecturas en cola o algún lector sigue activo
+     */
+    bool hasMoreData() override;
+
+    /**
+     * @brief Lee un lote de lecturas tomando de las colas en round-robin
+     * @param out Arreglo destino
+     * @param max Capacidad de out
+     * @return Lecturas obtenidas; 0 solo cuando todos los lectores terminaron
+     * @details Espera hasta tener al menos una lectura y vacía cada cola por lotes
+     */
+    size_t read(int* out, size_t max) override;
+
+    /**
+     * @brief Estado de la fuente
+     * @return OK mientras algún puerto tenga datos; IO_ERROR si algún puerto no pudo
+     *         abrirse o falló al leer (una vez vaciadas las colas); END_OF_DATA en otro caso
+     */
+    ReadStatus getStatus() const override;
+
+    /**
+     * @brief Obtiene el número de puertos
+     * @return Puertos abiertos
+     */
+    size_t getPortCount() const;
+
+    /**
+     * @brief Obtiene el número de lecturas recibidas por un puerto
+     * @param index Índice del puerto
+     * @return Lecturas recibidas
+     */
+    uint64_t getReadings(size_t index) const;
+
+    /**
+     * @brief Obtiene el puerto serial subyacente (para sus contadores)
+     * @param index Índice del puerto
+     * @return Puerto serial
+     */
+    const SerialSource& getPort(size_t index) const;
+
+    /**
+     * @brief Obtiene los contadores sumados de todos los puertos
+     * @return Lecturas, bytes, timeouts y descartes de todos los puertos
+     */
+    SourceStats getStats() const override;
+
+    /**
+     * @brief Detiene la lectura de los puertos sin descartar lo ya recibido
+     * @return true: read() entrega lo que quede en las colas y el último lote de cada
+     *         lector, y devuelve 0 cuando todos terminaron
+     */
+    bool stopAcquisition() override;
+
+    /**
+     * @brief Destructor que detiene los lectores y cierra los puertos
+     * @details Lo que siga en las colas se descarta: para no perder lecturas al detener,
+     *          llamar antes a stopAcquisition() y vaciar la fuente con read()
+     */
+    ~MultiSerialSource();
+};
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file ProgressReporter.cpp
+ * @brief Implementación de ProgressReporter
+ */
+
+#include "ProgressReporter.h"
+#include "Logger.h"
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const double RATE_SMOOTHING = 0.3;  ///< Peso del último intervalo en el ritmo suavizado
+
+/**
+ * @brief Da formato a una duración: segundos con un decimal bajo el minuto, si no h:mm:ss
+ * @param seconds Segundos
+ * @return Texto (ej: "4.2 s", "0:02:05")
+ */
+std::string formatDuration(double seconds) {
+    std::ostringstream text;
+    if (seconds < 60) {
+        text << std::fixed << std::setprecision(1) << (seconds > 0 ? seconds : 0) << " s";
+        return text.str();
+    }
+    uint64_t total = static_cast<uint64_t>(seconds + 0.5);
+    text << total / 3600 << ':' << std::setw(2) << std::setfill('0') << (total / 60) % 60
+         << ':' << std::setw(2) << std::setfill('0') << total % 60;
+    return text.str();
+}
+
+} // namespace
+
+ProgressReporter::ProgressReporter(const std::string& phaseLabel, const std::string& unitName,
+                                   int everyMs)
+    : label(phaseLabel), unit(unitName), intervalMs(everyMs > 0 ? everyMs : DEFAULT_INTERVAL_MS),
+      done(0), total(0), lastDone(0), smoothedRate(0), stopping(false) {}
+
+void ProgressReporter::start(uint64_t expected) {
+    if (reporter.joinable()) {
+        return;
+    }
+    done.store(0, std::memory_order_relaxed);
+    total.store(expected, std::memory_order_relaxed);
+    startTime = Clock::now();
+    lastTime = startTime;
+    lastDone = 0;
+    smoothedRate = 0;
+    stopping = false;
+    reporter = std::thread(&ProgressReporter::reportLoop, this);
+}
+
+void ProgressReporter::reportLoop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopCv.wait_for(lock, std::chrono::milliseconds(intervalMs),
+                            [this]() { return stopping; })) {
+        lock.unlock();
+        report();
+        lock.lock();
+    }
+}
+
+void ProgressReporter::report() {
+    Clock::time_point now = Clock::now();
+    uint64_t current = done.load(std::memory_order_relaxed);
+    double seconds = std::chrono::duration<double>(now - lastTime).count();
+    if (current == lastDone || seconds <= 0) {
+        return;
+    }
+
+    double rate = (current - lastDone) / seconds;
+    smoothedRate = smoothedRate > 0
+                       ? RATE_SMOOTHING * rate + (1 - RATE_SMOOTHING) * smoothedRate
+                       : rate;
+    lastTime = now;
+    lastDone = current;
+
+    Logger& log = Logger::instance();
+    if (!log.enabled(LogLevel::INFO)) {
+        return;
+    }
+    std::ostringstream line;
+    line << label << ": " << current;
+    uint64_t expected = total.load(std::memory_order_relaxed);
+    if (expected > 0) {
+        // El total puede ser una estimación: el porcentaje no pasa de 99 hasta finish()
+        double percent = 100.0 * current / expected;
+        line << " de " << expected << " " << unit << " ("
+             << static_cast<int>(percent < 99 ? percent : 99) << "%)";
+    } else {
+        line << " " << unit;
+    }
+    line << ", " << static_cast<uint64_t>(rate) << " " << unit << "/s";
+    if (expected > current && smoothedRate > 0) {
+        line << ", ETA " << formatDuration((expected - current) / smoothedRate);
+    }
+    log.write(LogLevel::INFO, line.str());
+}
+
+void ProgressReporter::finish() {
+    if (!reporter.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    stopCv.notify_one();
+    reporter.join();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+    uint64_t current = done.load(std::memory_order_relaxed);
+    std::ostringstream line;
+    line << label << ": " << current << " " << unit << " en " << formatDuration(seconds);
+    if (seconds > 0) {
+        line << " (" << static_cast<uint64_t>(current / seconds) << " " << unit << "/s)";
+    }
+    Logger::instance().write(LogLevel::INFO, line.str());
+}
+
+ProgressReporter::~ProgressReporter() {
+    if (reporter.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        stopCv.notify_one();
+        reporter.join();
+    }
+}
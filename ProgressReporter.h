@@ -0,0 +1,105 @@
+/**
+ * @file ProgressReporter.h
+ * @brief Avance periódico de una fase: registros procesados, ritmo y tiempo restante
+ * @details Reemplaza los mensajes por lectura: el hilo que trabaja solo suma a un
+ *          contador atómico y un hilo aparte escribe una línea por intervalo en el
+ *          Logger (nivel INFO).
+ */
+
+#ifndef PROGRESSREPORTER_H
+#define PROGRESSREPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @class ProgressReporter
+ * @brief Informa el avance de una fase con ritmo y, si se conoce el total, porcentaje y ETA
+ * @details El ritmo del ETA es un promedio móvil exponencial de los intervalos, para
+ *          que una pausa breve del serial no haga saltar la estimación. Sin avance
+ *          desde el intervalo anterior no se escribe nada.
+ */
+class ProgressReporter {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::string label;                  ///< Prefijo de cada línea (ej: "Fase 2")
+    std::string unit;                   ///< Nombre de lo que se cuenta (ej: "registros")
+    int intervalMs;                     ///< Período entre líneas
+    std::atomic<uint64_t> done;         ///< Unidades procesadas
+    std::atomic<uint64_t> total;        ///< Unidades esperadas (0 = desconocido)
+    Clock::time_point startTime;        ///< Llamada a start()
+    Clock::time_point lastTime;         ///< Línea anterior (solo el hilo informante)
+    uint64_t lastDone;                  ///< done en la línea anterior (solo el hilo informante)
+    double smoothedRate;                ///< Unidades/s suavizadas (solo el hilo informante)
+
+    std::thread reporter;               ///< Hilo que escribe las líneas
+    std::mutex mtx;                     ///< Protege stopping
+    std::condition_variable stopCv;     ///< Despierta al informante para terminar
+    bool stopping;                      ///< Solicita al informante terminar
+
+    ProgressReporter(const ProgressReporter&);            ///< No copiable
+    ProgressReporter& operator=(const ProgressReporter&); ///< No asignable
+
+    /**
+     * @brief Bucle del hilo informante
+     */
+    void reportLoop();
+
+    /**
+     * @brief Escribe una línea de avance si hubo progreso
+     */
+    void report();
+
+public:
+    static const int DEFAULT_INTERVAL_MS = 1000;  ///< Una línea por segundo
+
+    /**
+     * @brief Constructor
+     * @param phaseLabel Prefijo de cada línea
+     * @param unitName Nombre de lo que se cuenta, en plural
+     * @param everyMs Período entre líneas
+     */
+    ProgressReporter(const std::string& phaseLabel, const std::string& unitName,
+                     int everyMs = DEFAULT_INTERVAL_MS);
+
+    /**
+     * @brief Pone el contador en cero e inicia el hilo informante
+     * @param expected Unidades esperadas (0 = desconocido: sin porcentaje ni ETA)
+     */
+    void start(uint64_t expected = 0);
+
+    /**
+     * @brief Suma unidades procesadas (cualquier hilo)
+     * @param count Unidades
+     * @details Una suma atómica relajada; conviene llamarla por lote, no por registro
+     */
+    void add(uint64_t count) {
+        done.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Obtiene las unidades procesadas
+     * @return Unidades sumadas desde start()
+     */
+    uint64_t getDone() const {
+        return done.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Detiene el hilo informante y escribe el resumen (total, tiempo y ritmo)
+     */
+    void finish();
+
+    /**
+     * @brief Destructor que detiene el hilo informante sin resumen
+     */
+    ~ProgressReporter();
+};
+
+#endif
@@ -0,0 +1,367 @@
+/**
+ * @file Record.h
+ * @brief Tipos de registro, extractores de clave y comparadores para el ordenamiento
+ * @details El buffer, las fuentes, los chunks y la fusión se parametrizan con el tipo de
+ *          registro T, un extractor de clave KeyOf y un comparador Compare. Para int los
+ *          valores por defecto (IdentityKey/KeyLess) se reducen en línea a la comparación
+ *          de enteros de siempre; TelemetryRecord es un registro de tamaño fijo con clave
+ *          de 64 bits que también usa las rutas de Radix Sort y de chunks binarios.
+ */
+
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+/**
+ * @struct TelemetryRecord
+ * @brief Lectura de telemetría con marca de tiempo, sensor y valor (16 bytes)
+ * @details En texto se escribe como "timestamp,sensor,valor" en una línea
+ */
+struct TelemetryRecord {
+    int64_t timestamp;   ///< Marca de tiempo (p. ej. microsegundos desde la época)
+    uint32_t sensorId;   ///< Identificador del sensor
+    int32_t value;       ///< Valor medido
+};
+
+/**
+ * @struct CountedValue
+ * @brief Valor con su número de repeticiones (modo de agregación, 8 bytes)
+ * @details Con --aggregate cada chunk guarda un par por valor distinto en lugar de cada
+ *          repetición; en texto se escribe como "valor,repeticiones" en una línea
+ */
+struct CountedValue {
+    int32_t value;    ///< Valor leído
+    uint32_t count;   ///< Veces que se leyó
+
+    CountedValue() : value(0), count(0) {}
+    CountedValue(int32_t v, uint32_t c) : value(v), count(c) {}
+};
+
+/**
+ * @struct IdentityKey
+ * @brief Extractor de clave que usa el registro completo (tipos escalares como int)
+ */
+template<typename T>
+struct IdentityKey {
+    typedef T KeyType;  ///< Tipo de la clave
+
+    static T key(const T& record) {
+        return record;
+    }
+};
+
+/**
+ * @struct TimestampKey
+ * @brief Ordena TelemetryRecord por marca de tiempo
+ */
+struct TimestampKey {
+    typedef int64_t KeyType;  ///< Tipo de la clave
+
+    static int64_t key(const TelemetryRecord& record) {
+        return record.timestamp;
+    }
+};
+
+/**
+ * @struct ValueKey
+ * @brief Ordena TelemetryRecord por valor medido
+ */
+struct ValueKey {
+    typedef int32_t KeyType;  ///< Tipo de la clave
+
+    static int32_t key(const TelemetryRecord& record) {
+        return record.value;
+    }
+};
+
+/**
+ * @struct CountedValueKey
+ * @brief Ordena CountedValue por valor
+ */
+struct CountedValueKey {
+    typedef int32_t KeyType;  ///< Tipo de la clave
+
+    static int32_t key(const CountedValue& record) {
+        return record.value;
+    }
+};
+
+/**
+ * @struct KeyLess
+ * @brief Comparador ascendente sobre la clave extraída por KeyOf
+ * @details Es el comparador por defecto; solo con él se puede usar Radix Sort, que
+ *          ordena por los bytes de la clave y no llama al comparador
+ */
+template<typename KeyOf>
+struct KeyLess {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const {
+        return KeyOf::key(a) < KeyOf::key(b);
+    }
+};
+
+/**
+ * @struct RadixKey
+ * @brief Convierte una clave entera en bits sin signo con el mismo orden
+ * @details Invierte el bit de signo de las claves con signo para que los negativos
+ *          queden antes que los positivos al ordenar byte por byte
+ */
+template<typename K>
+struct RadixKey {
+    typedef typename std::make_unsigned<K>::type Bits;  ///< Representación sin signo
+
+    static Bits bits(K key) {
+        Bits b = static_cast<Bits>(key);
+        return std::is_signed<K>::value ? static_cast<Bits>(b ^ (Bits(1) << (sizeof(K) * 8 - 1))) : b;
+    }
+};
+
+/**
+ * @brief Indica si un byte separa números en el texto de un chunk
+ * @param c Byte
+ * @return true para espacio, tabulador, coma, '\r' y '\n'
+ */
+inline bool isTextSeparator(char c) {
+    return c == ' ' || c == ',' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/**
+ * @brief Interpreta un entero decimal desde un rango de bytes
+ * @param p Posición inicial; al volver apunta después del número
+ * @param end Fin del rango
+ * @param value Valor leído
+ * @return true si se encontró un número antes de end
+ * @details Salta separadores (espacios, comas, '\r', '\n') y acepta signo '-'. Cualquier
+ *          otro byte, un '-' sin dígitos, un número pegado a otro byte (ej: "12a4") o
+ *          fuera del rango de I (como el failbit de operator>>) devuelve false dejando
+ *          p antes de end, en el inicio del número; false con p == end es el fin normal
+ *          de los datos.
+ */
+template<typename I>
+bool parseDecimal(const char*& p, const char* end, I& value) {
+    typedef typename std::make_unsigned<I>::type Unsigned;
+
+    // Saltar separadores hasta el primer dígito o signo
+    while (p < end && isTextSeparator(*p)) {
+        p++;
+    }
+    if (p >= end) {
+        return false;
+    }
+
+    const char* start = p;
+    bool negative = (*p == '-');
+    p += negative;
+
+    // Magnitud máxima: |MIN| con signo '-' (0 si I no tiene signo), MAX sin él
+    const Unsigned maxValue = static_cast<Unsigned>(std::numeric_limits<I>::max());
+    const Unsigned limit = !negative ? maxValue
+                         : std::is_signed<I>::value ? static_cast<Unsigned>(maxValue + 1) : 0;
+
+    Unsigned acc = 0;
+    unsigned int digit;
+    const char* digits = p;
+    while (p < end && (digit = static_cast<unsigned char>(*p - '0')) <= 9) {
+        if (digit > limit || acc > (limit - digit) / 10) {
+            p = start;
+            return false;
+        }
+        acc = static_cast<Unsigned>(acc * 10 + digit);
+        p++;
+    }
+    if (p == digits || (p < end && !isTextSeparator(*p))) {
+        p = start;
+        return false;
+    }
+
+    value = static_cast<I>(negative ? Unsigned(0) - acc : acc);
+    return true;
+}
+
+/**
+ * @struct RecordText
+ * @brief Formato de texto de un tipo de registro (chunks de texto y salida final)
+ * @details Cada especialización escribe un registro por línea y sabe leerlo de vuelta
+ *          desde un stream (FileSource) o desde bytes mapeados (MappedFileSource)
+ */
+template<typename T>
+struct RecordText;
+
+/**
+ * @brief Formato de texto de int: un entero decimal por línea
+ */
+template<>
+struct RecordText<int> {
+    template<typename Writer>
+    static void write(Writer& writer, int value) {
+        writer.writeInt(value);
+    }
+
+    static bool read(std::istream& in, int& value) {
+        return static_cast<bool>(in >> value);
+    }
+
+    static bool parse(const char*& p, const char* end, int& value) {
+        return parseDecimal(p, end, value);
+    }
+};
+
+/**
+ * @brief Formato de texto de TelemetryRecord: "timestamp,sensor,valor" por línea
+ */
+template<>
+struct RecordText<TelemetryRecord> {
+    template<typename Writer>
+    static void write(Writer& writer, const TelemetryRecord& record) {
+        char line[48];
+        int len = std::snprintf(line, sizeof(line), "%lld,%u,%d\n",
+                                static_cast<long long>(record.timestamp),
+                                static_cast<unsigned>(record.sensorId),
+                                static_cast<int>(record.value));
+        writer.write(line, static_cast<size_t>(len));
+    }
+
+    static bool read(std::istream& in, TelemetryRecord& record) {
+        long long timestamp;
+        unsigned long sensorId;
+        long value;
+        char sep1;
+        char sep2;
+        if (!(in >> timestamp >> sep1 >> sensorId >> sep2 >> value) || sep1 != ',' || sep2 != ',') {
+            return false;
+        }
+        record.timestamp = timestamp;
+        record.sensorId = static_cast<uint32_t>(sensorId);
+        record.value = static_cast<int32_t>(value);
+        return true;
+    }
+
+    static bool parse(const char*& p, const char* end, TelemetryRecord& record) {
+        const char* start = p;
+        if (!parseDecimal(p, end, record.timestamp)) {
+            return false;
+        }
+        if (parseDecimal(p, end, record.sensorId) && parseDecimal(p, end, record.value)) {
+            return true;
+        }
+        p = start;  // Registro incompleto: se informa como dato inválido, no como fin
+        return false;
+    }
+};
+
+/**
+ * @brief Formato de texto de CountedValue: "valor,repeticiones" por línea
+ */
+template<>
+struct RecordText<CountedValue> {
+    template<typename Writer>
+    static void write(Writer& writer, const CountedValue& record) {
+        char line[32];
+        int len = std::snprintf(line, sizeof(line), "%d,%u\n", static_cast<int>(record.value),
+                                static_cast<unsigned>(record.count));
+        writer.write(line, static_cast<size_t>(len));
+    }
+
+    static bool read(std::istream& in, CountedValue& record) {
+        long value;
+        unsigned long count;
+        char sep;
+        if (!(in >> value >> sep >> count) || sep != ',') {
+            return false;
+        }
+        record.value = static_cast<int32_t>(value);
+        record.count = static_cast<uint32_t>(count);
+        return true;
+    }
+
+    static bool parse(const char*& p, const char* end, CountedValue& record) {
+        const char* start = p;
+        if (!parseDecimal(p, end, record.value)) {
+            return false;
+        }
+        if (parseDecimal(p, end, record.count)) {
+            return true;
+        }
+        p = start;  // Registro incompleto: se informa como dato inválido, no como fin
+        return false;
+    }
+};
+
+/**
+ * @struct RecordAggregate
+ * @brief Combinación de registros con la misma clave durante la fusión
+ * @details Por defecto no combina: cada registro se escribe tal cual. La
+ *          especialización de CountedValue suma las repeticiones de un mismo valor que
+ *          llegan de distintos chunks y sabe escribir el par expandido (una línea por
+ *          repetición). ENABLED es constante, así el camino de int no cambia.
+ */
+template<typename T>
+struct RecordAggregate {
+    static const bool ENABLED = false;  ///< El tipo no se combina
+    static const uint16_t EXPANDED_WIDTH = sizeof(T); ///< sizeof de lo que escribe writeExpanded
+
+    static bool combine(T& accumulated, const T& record) {
+        (void)accumulated;
+        (void)record;
+        return false;
+    }
+
+    static uint64_t count(const T& record) {
+        (void)record;
+        return 1;
+    }
+
+    template<typename Writer>
+    static void writeExpanded(Writer& writer, const T& record) {
+        RecordText<T>::write(writer, record);
+    }
+};
+
+template<>
+struct RecordAggregate<CountedValue> {
+    static const bool ENABLED = true;   ///< Los pares de igual valor se suman
+    static const uint16_t EXPANDED_WIDTH = sizeof(int32_t); ///< Se expande a enteros
+
+    /**
+     * @return false si los valores difieren o la suma no cabe en 32 bits (se escriben
+     *         dos pares con el mismo valor, que siguen siendo válidos)
+     */
+    static bool combine(CountedValue& accumulated, const CountedValue& record) {
+        if (accumulated.value != record.value ||
+            record.count > UINT32_MAX - accumulated.count) {
+            return false;
+        }
+        accumulated.count += record.count;
+        return true;
+    }
+
+    static uint64_t count(const CountedValue& record) {
+        return record.count;
+    }
+
+    /**
+     * @brief Escribe una repetición como en la salida sin agregar (un entero por línea)
+     */
+    template<typename Writer>
+    static void writeExpanded(Writer& writer, const CountedValue& record) {
+        writer.writeInt(record.value);
+    }
+};
+
+/**
+ * @brief Imprime un TelemetryRecord (usado por CircularBuffer::print)
+ * @param out Flujo de salida
+ * @param record Registro a imprimir
+ * @return El mismo flujo
+ */
+inline std::ostream& operator<<(std::ostream& out, const TelemetryRecord& record) {
+    return out << '(' << record.timestamp << ", " << record.sensorId << ", " << record.value << ')';
+}
+
+#endif
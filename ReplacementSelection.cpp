@@ -0,0 +1,235 @@
+/**
+ * @file ReplacementSelection.cpp
+ * @brief Implementación de ReplacementSelection
+ */
+
+#include "ReplacementSelection.h"
+#include "Logger.h"
+#include <iostream>
+#include <limits>
+
+ReplacementSelection::ReplacementSelection(int size, ChunkFormat format,
+                                           const std::string& prefix)
+    : capacity(size < 1 ? 1 : size), chunkFormat(format), chunkPrefix(prefix),
+      heap(nullptr), heapSize(0), manifest(nullptr), progress(nullptr),
+      writeFailed(false) {
+    heap = new uint64_t[capacity];
+}
+
+int ReplacementSelection::chooseCapacity(size_t memoryBudget) {
+    size_t writerBytes = 2 * BlockWriter::DEFAULT_BLOCK_SIZE;
+    size_t available = memoryBudget > writerBytes ? memoryBudget - writerBytes : 0;
+    size_t records = available / sizeof(uint64_t);
+
+    const size_t MAX_RECORDS = static_cast<size_t>(std::numeric_limits<int>::max());
+    if (records > MAX_RECORDS) records = MAX_RECORDS;
+    return records < 1 ? 1 : static_cast<int>(records);
+}
+
+void ReplacementSelection::siftDown(int pos) {
+    uint64_t key = heap[pos];
+    while (true) {
+        int child = 2 * pos + 1;
+        if (child >= heapSize) break;
+        if (child + 1 < heapSize && heap[child + 1] < heap[child]) child++;
+        if (heap[child] >= key) break;
+        heap[pos] = heap[child];
+        pos = child;
+    }
+    heap[pos] = key;
+}
+
+bool ReplacementSelection::closeRun(BlockWriter& writer, int index, const std::string& filename,
+                                    uint64_t count, int first, int last) {
+    if (chunkFormat == ChunkFormat::DELTA) {
+        encoder.flush(writer);
+    }
+    bool ok = writer.close();
+    if (ok && chunkFormat != ChunkFormat::TEXT) {
+        ChunkHeader header;
+        makeChunkHeader(header, count, first, last, sizeof(int), chunkFormat);
+        ok = patchChunkHeader(filename, header);
+    }
+    if (ok && manifest != nullptr) {
+        ok = manifest->addChunk(index, filename, count);
+    }
+    return ok;
+}
+
+std::vector<std::string> ReplacementSelection::generate(DataSource* source,
+                                                        const std::atomic<bool>& stopRequested,
+                                                        int startIndex) {
+    std::vector<std::string> runs;
+    runLengths.clear();
+    heapSize = 0;
+    writeFailed = false;
+
+    // Entrada por lotes: una llamada virtual por INPUT_BATCH datos. Con la detención solo
+    // se piden los datos que la fuente ya recibió (si los retiene), y el lote en curso se
+    // entrega completo: esos datos no se pueden volver a leer
+    std::vector<int> input(INPUT_BATCH);
+    size_t inputPos = 0;
+    size_t inputSize = 0;
+    bool inputDone = false;
+    bool draining = false;
+    auto nextInput = [&](int& value) -> bool {
+        if (inputPos == inputSize) {
+            if (inputDone) return false;
+            if (stopRequested && !draining) {
+                draining = true;
+                if (!source->stopAcquisition()) {
+                    inputDone = true;
+                    return false;
+                }
+            }
+            inputSize = source->read(input.data(), input.size());
+            inputPos = 0;
+            if (progress != nullptr) progress->add(inputSize);
+            if (inputSize == 0) {
+                inputDone = true;
+                return false;
+            }
+        }
+        value = input[inputPos++];
+        return true;
+    };
+
+    // Llenado inicial: todo entra en la corrida 0
+    int incoming;
+    while (heapSize < capacity && nextInput(incoming)) {
+        heap[heapSize++] = makeKey(0, incoming);
+    }
+    for (int i = heapSize / 2 - 1; i >= 0; i--) {
+        siftDown(i);
+    }
+
+    uint32_t currentRun = 0;
+    BlockWriter* writer = nullptr;
+    std::string filename;
+    uint64_t count = 0;
+    int first = 0;
+    int last = 0;
+
+    while (heapSize > 0) {
+        uint64_t top = heap[0];
+        uint32_t run = static_cast<uint32_t>(top >> 32);
+        int value = static_cast<int>(static_cast<uint32_t>(top) ^ 0x80000000u);
+
+        if (writer == nullptr || run != currentRun) {
+            if (writer != nullptr) {
+                bool closed = closeRun(*writer, startIndex + static_cast<int>(runs.size()),
+                                       filename, count, first, last);
+                delete writer;
+                writer = nullptr;
+                if (!closed) {
+                    std::cerr << "Error: No se pudo cerrar la corrida " << filename << std::endl;
+                    writeFailed = true;
+                    break;
+                }
+                runs.push_back(filename);
+                runLengths.push_back(count);
+            }
+
+            currentRun = run;
+            filename = chunkPrefix + std::to_string(startIndex + runs.size()) + ".tmp";
+            writer = new BlockWriter(filename);
+            if (!writer->isOpen()) {
+                std::cerr << "Error: No se pudo crear la corrida " << filename << std::endl;
+                delete writer;
+                writer = nullptr;
+                writeFailed = true;
+                break;
+            }
+            count = 0;
+            Logger::instance().write(LogLevel::DEBUG, "Escribiendo corrida " + filename + "...");
+
+            if (chunkFormat != ChunkFormat::TEXT) {
+                ChunkHeader header;
+                makeChunkHeader(header, 0, 0, 0, sizeof(int), chunkFormat);
+                writer->write(&header, sizeof(header));
+            }
+        }
+
+        if (chunkFormat == ChunkFormat::DELTA) {
+            encoder.append(*writer, value);
+        } else if (chunkFormat == ChunkFormat::BINARY) {
+            writer->write(&value, sizeof(value));
+        } else {
+            writer->writeInt(value);
+        }
+        if (count == 0) first = value;
+        last = value;
+        count++;
+
+        // Reemplazo: el nuevo dato sigue en la corrida si no rompe el orden
+        if (nextInput(incoming)) {
+            heap[0] = makeKey(incoming < value ? currentRun + 1 : currentRun, incoming);
+        } else {
+            heap[0] = heap[--heapSize];
+        }
+        if (heapSize > 0) {
+            siftDown(0);
+        }
+    }
+
+    if (writer != nullptr) {
+        if (closeRun(*writer, startIndex + static_cast<int>(runs.size()), filename, count, first, last)) {
+            runs.push_back(filename);
+            runLengths.push_back(count);
+        } else {
+            std::cerr << "Error: No se pudo cerrar la corrida " << filename << std::endl;
+            writeFailed = true;
+        }
+        delete writer;
+    }
+
+    return runs;
+}
+
+void ReplacementSelection::setManifest(ChunkManifest* chunkManifest) {
+    manifest = chunkManifest;
+}
+
+void ReplacementSelection::setProgress(ProgressReporter* reporter) {
+    progress = reporter;
+}
+
+const std::vector<uint64_t>& ReplacementSelection::getRunLengths() const {
+    return runLengths;
+}
+
+bool ReplacementSelection::hasWriteFailed() const {
+    return writeFailed;
+}
+
+void ReplacementSelection::printReport(std::ostream& out) const {
+    if (runLengths.empty()) {
+        out << "Selección por reemplazo: 0 corridas." << std::endl;
+        return;
+    }
+
+    uint64_t total = 0;
+    uint64_t shortest = runLengths[0];
+    uint64_t longest = runLengths[0];
+    for (size_t i = 0; i < runLengths.size(); i++) {
+        total += runLengths[i];
+        if (runLengths[i] < shortest) shortest = runLengths[i];
+        if (runLengths[i] > longest) longest = runLengths[i];
+    }
+    double average = static_cast<double>(total) / runLengths.size();
+
+    out << "Selección por reemplazo: " << runLengths.size() << " corridas, "
+        << total << " datos" << std::endl;
+    out << "  Longitud mín/prom/máx: " << shortest << " / " << average << " / "
+        << longest << " (prom = " << average / capacity << "x memoria)" << std::endl;
+    out << "  Longitudes: [";
+    for (size_t i = 0; i < runLengths.size(); i++) {
+        out << runLengths[i];
+        if (i < runLengths.size() - 1) out << ", ";
+    }
+    out << "]" << std::endl;
+}
+
+ReplacementSelection::~ReplacementSelection() {
+    delete[] heap;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file ReplacementSelection.h
+ * @brief Generación de corridas por selección por reemplazo
+ * @details Alternativa a "llenar, ordenar y volcar": con un heap del tamaño del buffer
+ *          produce corridas de ~2x la memoria en datos aleatorios y una sola corrida en
+ *          datos casi ordenados
+ */
+
+#ifndef REPLACEMENTSELECTION_H
+#define REPLACEMENTSELECTION_H
+
+#include "DataSource.h"
+#include "ChunkFile.h"
+#include "BlockWriter.h"
+#include "ChunkManifest.h"
+#include "ProgressReporter.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class ReplacementSelection
+ * @brief Generador de corridas con un min-heap etiquetado por número de corrida
+ * @details Cada entrada del heap combina (corrida, valor) en una clave de 64 bits. Se
+ *          extrae el mínimo, se escribe en la corrida actual y se reemplaza por el
+ *          siguiente dato de la fuente; si ese dato es menor que el último escrito ya no
+ *          cabe en la corrida actual y se etiqueta para la siguiente.
+ */
+class ReplacementSelection {
+private:
+    int capacity;                      ///< Número de entradas del heap (tamaño de memoria)
+    ChunkFormat chunkFormat;           ///< Formato de las corridas escritas
+    DeltaBlockEncoder<int> encoder;    ///< Bloques de la corrida actual en formato DELTA
+    std::string chunkPrefix;           ///< Prefijo de los nombres de corrida
+    uint64_t* heap;                    ///< Min-heap de claves (corrida << 32 | valor)
+    int heapSize;                      ///< Entradas válidas en el heap
+    std::vector<uint64_t> runLengths;  ///< Longitud de cada corrida escrita
+    ChunkManifest* manifest;           ///< Registro durable de corridas (opcional)
+    ProgressReporter* progress;        ///< Avance en lecturas recibidas (opcional)
+    bool writeFailed;                  ///< Una corrida no se pudo escribir en el último generate()
+
+    static const size_t INPUT_BATCH = 1024; ///< Datos pedidos a la fuente por lectura
+
+    ReplacementSelection(const ReplacementSelection&);            ///< No copiable
+    ReplacementSelection& operator=(const ReplacementSelection&); ///< No asignable
+
+    /**
+     * @brief Combina número de corrida y valor en una clave ordenable
+     * @param run Número de corrida
+     * @param value Valor
+     * @return Clave de 64 bits: la corrida domina y el valor desempata
+     */
+    static uint64_t makeKey(uint32_t run, int value) {
+        return (static_cast<uint64_t>(run) << 32) |
+               (static_cast<uint32_t>(value) ^ 0x80000000u);
+    }
+
+    /**
+     * @brief Restaura la propiedad de heap hacia abajo desde una posición
+     * @param pos Posición inicial
+     */
+    void siftDown(int pos);
+
+    /**
+     * @brief Cierra la corrida actual (completa el encabezado en formato binario)
+     * @param writer Escritor de la corrida
+     * @param index Número de la corrida
+     * @param filename Nombre de la corrida
+     * @param count Registros escritos
+     * @param first Primer valor escrito (mínimo)
+     * @param last Último valor escrito (máximo)
+     * @return true si la corrida se cerró y quedó registrada en el manifiesto
+     */
+    bool closeRun(BlockWriter& writer, int index, const std::string& filename, uint64_t count,
+                  int first, int last);
+
+public:
+    /**
+     * @brief Constructor que reserva el heap
+     * @param size Número de datos que caben en memoria
+     * @param format Formato de las corridas
+     * @param prefix Prefijo de los nombres ("chunk_0" produce chunk_01.tmp, chunk_02.tmp...)
+     */
+    ReplacementSelection(int size, ChunkFormat format, const std::string& prefix = "chunk_0");
+
+    /**
+     * @brief Calcula cuántos datos caben en el heap con un presupuesto de memoria
+     * @param memoryBudget Bytes disponibles para la Fase 1
+     * @return Capacidad del heap (al menos 1)
+     * @details Cada dato ocupa una clave de 64 bits; se reservan los bloques del BlockWriter
+     */
+    static int chooseCapacity(size_t memoryBudget);
+
+    /**
+     * @brief Lee toda la fuente y escribe las corridas ordenadas
+     * @param source Fuente de datos
+     * @param stopRequested Bandera de detención: se llama a stopAcquisition() de la fuente
+     *        y el heap, el resto del lote y lo que la fuente ya había recibido se vacían
+     *        en la corrida actual y la siguiente antes de cerrarlas
+     * @param startIndex Número de la primera corrida
+     * @return Nombres de las corridas escritas, en orden
+     * @details Si una corrida no se puede crear o cerrar se informa y se deja de generar
+     *          (ver hasWriteFailed())
+     */
+    std::vector<std::string> generate(DataSource* source, const std::atomic<bool>& stopRequested,
+                                      int startIndex = 1);
+
+    /**
+     * @brief Registra cada corrida cerrada en un manifiesto durable
+     * @param chunkManifest Manifiesto (nullptr para no registrar)
+     */
+    void setManifest(ChunkManifest* chunkManifest);
+
+    /**
+     * @brief Informa las lecturas recibidas, un lote a la vez
+     * @param reporter Avance (nullptr para no informar)
+     */
+    void setProgress(ProgressReporter* reporter);
+
+    /**
+     * @brief Obtiene la longitud de cada corrida del último generate()
+     * @return Registros por corrida
+     */
+    const std::vector<uint64_t>& getRunLengths() const;
+
+    /**
+     * @brief Indica si el último generate() se detuvo porque una corrida no se pudo escribir
+     * @return true si quedaron datos leídos sin guardar
+     */
+    bool hasWriteFailed() const;
+
+    /**
+     * @brief Imprime un resumen de las longitudes de corrida
+     * @param out Stream de salida
+     * @details Muestra cantidad, mínimo, promedio, máximo y la relación promedio/memoria
+     */
+    void printReport(std::ostream& out) const;
+
+    /**
+     * @brief Destructor que libera el heap
+     */
+    ~ReplacementSelection();
+};
+
+#endif
@@ -0,0 +1,339 @@
+/**
+ * @file RunMetrics.cpp
+ * @brief Implementación de RunMetrics
+ */
+
+#include "RunMetrics.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Cociente protegido contra división por cero
+ * @param numerator Numerador
+ * @param denominator Denominador
+ * @return numerator / denominator, o 0 si el denominador no es positivo
+ */
+double ratio(double numerator, double denominator) {
+    return denominator > 0 ? numerator / denominator : 0;
+}
+
+/**
+ * @brief Escribe la cabecera HELP/TYPE de una métrica Prometheus
+ * @param out Flujo de salida
+ * @param name Nombre de la métrica
+ * @param type counter, gauge, summary o histogram
+ * @param help Descripción
+ */
+void promHeader(std::ostream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << ' ' << help << '\n';
+    out << "# TYPE " << name << ' ' << type << '\n';
+}
+
+/**
+ * @brief Escribe una métrica Prometheus de un solo valor
+ * @param out Flujo de salida
+ * @param name Nombre de la métrica
+ * @param type counter o gauge
+ * @param help Descripción
+ * @param value Valor
+ */
+void promValue(std::ostream& out, const char* name, const char* type, const char* help,
+               double value) {
+    promHeader(out, name, type, help);
+    out << name << ' ' << value << '\n';
+}
+
+} // namespace
+
+RunMetrics::RunMetrics()
+    : startTime(Clock::now()), currentPhase(0), source(nullptr), chunkCount(0),
+      chunkRecords(0), chunkMinRecords(0), chunkMaxRecords(0), sortSecondsSum(0),
+      sortSecondsMax(0), spillSecondsSum(0), spillSecondsMax(0), mergeFanIn(0),
+      mergePasses(0), mergeRuns(0), mergeRecords(0), mergeOutputRecords(0),
+      mergeComparisons(0), exportIntervalMs(1000), exportStopping(false) {
+    for (int i = 0; i < 3; i++) {
+        phaseStart[i] = startTime;
+        phaseEnd[i] = startTime;
+    }
+    for (int b = 0; b < CHUNK_BUCKETS; b++) {
+        chunkSizeBuckets[b] = 0;
+    }
+}
+
+void RunMetrics::beginPhase(int phase) {
+    std::lock_guard<std::mutex> lock(mtx);
+    phaseStart[phase] = Clock::now();
+    phaseEnd[phase] = phaseStart[phase];
+    currentPhase = phase;
+}
+
+void RunMetrics::endPhase(int phase) {
+    std::lock_guard<std::mutex> lock(mtx);
+    phaseEnd[phase] = Clock::now();
+    if (currentPhase == phase) {
+        currentPhase = 0;
+    }
+}
+
+double RunMetrics::phaseSeconds(int phase) const {
+    Clock::time_point end = (currentPhase == phase) ? Clock::now() : phaseEnd[phase];
+    return std::chrono::duration<double>(end - phaseStart[phase]).count();
+}
+
+void RunMetrics::attachSource(const DataSource* dataSource) {
+    std::lock_guard<std::mutex> lock(mtx);
+    source = dataSource;
+    refreshSource();
+}
+
+void RunMetrics::detachSource() {
+    std::lock_guard<std::mutex> lock(mtx);
+    refreshSource();
+    source = nullptr;
+}
+
+void RunMetrics::refreshSource() {
+    if (source != nullptr) {
+        sourceStats = source->getStats();
+    }
+}
+
+void RunMetrics::recordChunk(uint64_t records, double sortSeconds, double spillSeconds) {
+    int bucket = 0;
+    while (bucket < CHUNK_BUCKETS - 1 && (1ULL << bucket) < records) {
+        bucket++;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (chunkCount == 0 || records < chunkMinRecords) chunkMinRecords = records;
+    if (records > chunkMaxRecords) chunkMaxRecords = records;
+    chunkCount++;
+    chunkRecords += records;
+    chunkSizeBuckets[bucket]++;
+    sortSecondsSum += sortSeconds;
+    spillSecondsSum += spillSeconds;
+    if (sortSeconds > sortSecondsMax) sortSecondsMax = sortSeconds;
+    if (spillSeconds > spillSecondsMax) spillSecondsMax = spillSeconds;
+}
+
+void RunMetrics::recordMerge(int fanIn, int passes, size_t runs, uint64_t recordsMerged,
+                             uint64_t outputRecords, uint64_t comparisons) {
+    std::lock_guard<std::mutex> lock(mtx);
+    mergeFanIn = fanIn;
+    mergePasses = passes;
+    mergeRuns = runs;
+    mergeRecords = recordsMerged;
+    mergeOutputRecords = outputRecords;
+    mergeComparisons = comparisons;
+}
+
+uint64_t RunMetrics::peakMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);        // bytes en macOS
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // KiB en Linux
+#endif
+#endif
+}
+
+void RunMetrics::writePrometheus(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(mtx);
+    refreshSource();
+    out.precision(12);
+
+    double ingestSeconds = phaseSeconds(1);
+    double mergeSeconds = phaseSeconds(2);
+    double elapsed = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    promValue(out, "esort_phase", "gauge", "Fase en curso (0 = ninguna, 1 = adquisicion, 2 = fusion)",
+              currentPhase);
+    promValue(out, "esort_uptime_seconds", "gauge", "Segundos desde el inicio de la ejecucion", elapsed);
+    promValue(out, "esort_ingested_records_total", "counter", "Lecturas validas recibidas de la fuente",
+              static_cast<double>(sourceStats.records));
+    promValue(out, "esort_ingested_bytes_total", "counter", "Bytes recibidos de la fuente",
+              static_cast<double>(sourceStats.bytes));
+    promValue(out, "esort_ingest_records_per_second", "gauge", "Lecturas por segundo en la Fase 1",
+              ratio(sourceStats.records, ingestSeconds));
+    promValue(out, "esort_ingest_bytes_per_second", "gauge", "Bytes por segundo en la Fase 1",
+              ratio(sourceStats.bytes, ingestSeconds));
+    promValue(out, "esort_serial_timeouts_total", "counter", "Timeouts de lectura del serial",
+              static_cast<double>(sourceStats.timeouts));
+    promValue(out, "esort_serial_invalid_lines_total", "counter", "Lineas de texto descartadas",
+              static_cast<double>(sourceStats.invalidLines));
+    promValue(out, "esort_serial_corrupt_frames_total", "counter", "Tramas COBS descartadas",
+              static_cast<double>(sourceStats.corruptFrames));
+
+    promHeader(out, "esort_chunk_sort_seconds", "summary", "Tiempo de ordenamiento por chunk");
+    out << "esort_chunk_sort_seconds_sum " << sortSecondsSum << '\n';
+    out << "esort_chunk_sort_seconds_count " << chunkCount << '\n';
+    promValue(out, "esort_chunk_sort_seconds_max", "gauge", "Mayor tiempo de ordenamiento de un chunk",
+              sortSecondsMax);
+    promHeader(out, "esort_chunk_spill_seconds", "summary", "Tiempo de escritura a disco por chunk");
+    out << "esort_chunk_spill_seconds_sum " << spillSecondsSum << '\n';
+    out << "esort_chunk_spill_seconds_count " << chunkCount << '\n';
+    promValue(out, "esort_chunk_spill_seconds_max", "gauge", "Mayor tiempo de escritura de un chunk",
+              spillSecondsMax);
+
+    promHeader(out, "esort_chunk_records", "histogram", "Datos por chunk");
+    uint64_t cumulative = 0;
+    for (int b = 0; b < CHUNK_BUCKETS && cumulative < chunkCount; b++) {
+        cumulative += chunkSizeBuckets[b];
+        out << "esort_chunk_records_bucket{le=\"" << (1ULL << b) << "\"} " << cumulative << '\n';
+    }
+    out << "esort_chunk_records_bucket{le=\"+Inf\"} " << chunkCount << '\n';
+    out << "esort_chunk_records_sum " << chunkRecords << '\n';
+    out << "esort_chunk_records_count " << chunkCount << '\n';
+
+    promValue(out, "esort_merge_fan_in", "gauge", "Fan-in maximo de la fusion", mergeFanIn);
+    promValue(out, "esort_merge_passes", "gauge", "Pasadas de la fusion", mergePasses);
+    promValue(out, "esort_merge_records_total", "counter", "Registros escritos en todas las pasadas",
+              static_cast<double>(mergeRecords));
+    promValue(out, "esort_merge_records_per_second", "gauge", "Registros fusionados por segundo",
+              ratio(mergeRecords, mergeSeconds));
+    promValue(out, "esort_merge_comparisons_per_record", "gauge", "Comparaciones del torneo por registro",
+              ratio(mergeComparisons, mergeRecords));
+    promValue(out, "esort_peak_memory_bytes", "gauge", "Memoria residente maxima del proceso",
+              static_cast<double>(peakMemoryBytes()));
+}
+
+void RunMetrics::writeJson(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(mtx);
+    refreshSource();
+    out.precision(12);
+
+    double ingestSeconds = phaseSeconds(1);
+    double mergeSeconds = phaseSeconds(2);
+    double elapsed = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+    out << "{\n";
+    out << "  \"elapsed_s\": " << elapsed << ",\n";
+    out << "  \"peak_memory_bytes\": " << peakMemoryBytes() << ",\n";
+
+    out << "  \"ingest\": {\"seconds\": " << ingestSeconds
+        << ", \"records\": " << sourceStats.records
+        << ", \"bytes\": " << sourceStats.bytes
+        << ", \"records_per_s\": " << ratio(sourceStats.records, ingestSeconds)
+        << ", \"bytes_per_s\": " << ratio(sourceStats.bytes, ingestSeconds)
+        << ", \"timeouts\": " << sourceStats.timeouts
+        << ", \"invalid_lines\": " << sourceStats.invalidLines
+        << ", \"corrupt_frames\": " << sourceStats.corruptFrames << "},\n";
+
+    out << "  \"chunks\": {\"count\": " << chunkCount
+        << ", \"records\": " << chunkRecords
+        << ", \"min_records\": " << chunkMinRecords
+        << ", \"max_records\": " << chunkMaxRecords
+        << ", \"mean_records\": " << ratio(chunkRecords, chunkCount)
+        << ",\n             \"sort_s\": {\"sum\": " << sortSecondsSum
+        << ", \"mean\": " << ratio(sortSecondsSum, chunkCount)
+        << ", \"max\": " << sortSecondsMax << "}"
+        << ",\n             \"spill_s\": {\"sum\": " << spillSecondsSum
+        << ", \"mean\": " << ratio(spillSecondsSum, chunkCount)
+        << ", \"max\": " << spillSecondsMax << "}"
+        << ",\n             \"size_histogram\": [";
+    bool first = true;
+    for (int b = 0; b < CHUNK_BUCKETS; b++) {
+        if (chunkSizeBuckets[b] == 0) continue;
+        out << (first ? "" : ", ") << "{\"le\": " << (1ULL << b)
+            << ", \"count\": " << chunkSizeBuckets[b] << "}";
+        first = false;
+    }
+    out << "]},\n";
+
+    out << "  \"merge\": {\"seconds\": " << mergeSeconds
+        << ", \"runs\": " << mergeRuns
+        << ", \"fan_in\": " << mergeFanIn
+        << ", \"passes\": " << mergePasses
+        << ", \"records\": " << mergeRecords
+        << ", \"output_records\": " << mergeOutputRecords
+        << ", \"records_per_s\": " << ratio(mergeRecords, mergeSeconds)
+        << ", \"comparisons\": " << mergeComparisons
+        << ", \"comparisons_per_record\": " << ratio(mergeComparisons, mergeRecords) << "}\n";
+    out << "}\n";
+}
+
+bool RunMetrics::writeJsonFile(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: No se pudo crear el archivo de métricas " << path << std::endl;
+        return false;
+    }
+    writeJson(file);
+    return static_cast<bool>(file);
+}
+
+void RunMetrics::writeExportFile() {
+    std::ostringstream text;
+    writePrometheus(text);
+
+    // Se escribe en un temporal y se renombra para que el lector nunca vea un archivo a medias
+    std::string temp = exportPath + ".tmp";
+    {
+        std::ofstream file(temp);
+        if (!file) return;
+        file << text.str();
+    }
+#ifdef _WIN32
+    std::remove(exportPath.c_str());
+#endif
+    std::rename(temp.c_str(), exportPath.c_str());
+}
+
+void RunMetrics::exportLoop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!exportStopping) {
+        lock.unlock();
+        writeExportFile();
+        lock.lock();
+        exportCv.wait_for(lock, std::chrono::milliseconds(exportIntervalMs),
+                          [this]() { return exportStopping; });
+    }
+}
+
+void RunMetrics::startExport(const std::string& path, int intervalMs) {
+    if (exporter.joinable()) {
+        return;
+    }
+    exportPath = path;
+    exportIntervalMs = intervalMs > 0 ? intervalMs : 1000;
+    exportStopping = false;
+    exporter = std::thread(&RunMetrics::exportLoop, this);
+}
+
+void RunMetrics::stopExport() {
+    if (!exporter.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        exportStopping = true;
+    }
+    exportCv.notify_all();
+    exporter.join();
+    writeExportFile();
+}
+
+RunMetrics::~RunMetrics() {
+    stopExport();
+}
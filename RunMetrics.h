@@ -0,0 +1,183 @@
+/**
+ * @file RunMetrics.h
+ * @brief Métricas de rendimiento por fase de una ejecución de E-Sort
+ * @details Reúne ingesta (lecturas/s, bytes/s), tiempos de ordenamiento y escritura por
+ *          chunk, distribución de tamaños de chunk, rendimiento de la fusión, errores del
+ *          serial y memoria máxima. Se exportan en JSON al terminar y periódicamente en
+ *          un archivo de texto con formato Prometheus mientras la ejecución avanza.
+ */
+
+#ifndef RUNMETRICS_H
+#define RUNMETRICS_H
+
+#include "DataSource.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+/**
+ * @class RunMetrics
+ * @brief Contenedor de métricas compartido por las fases y el exportador
+ * @details Los trabajadores de la Fase 1 registran sus chunks con recordChunk(); la
+ *          fuente se consulta con getStats() (contadores atómicos) desde el hilo
+ *          exportador, así que la ruta de lectura no paga ningún costo extra.
+ */
+class RunMetrics {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    static const int CHUNK_BUCKETS = 32;  ///< Cubetas potencia de dos del histograma de chunks
+
+    Clock::time_point startTime;          ///< Creación del objeto (inicio de la ejecución)
+
+    mutable std::mutex mtx;               ///< Protege todo lo que sigue
+    Clock::time_point phaseStart[3];      ///< Inicio de cada fase (índices 1 y 2)
+    Clock::time_point phaseEnd[3];        ///< Fin de cada fase (índices 1 y 2)
+    int currentPhase;                     ///< Fase en curso (0 = ninguna)
+    const DataSource* source;             ///< Fuente en lectura (nullptr fuera de la Fase 1)
+    SourceStats sourceStats;              ///< Última instantánea de la fuente
+    uint64_t chunkCount;                  ///< Chunks escritos
+    uint64_t chunkRecords;                ///< Datos en todos los chunks
+    uint64_t chunkMinRecords;             ///< Chunk más pequeño
+    uint64_t chunkMaxRecords;             ///< Chunk más grande
+    uint64_t chunkSizeBuckets[CHUNK_BUCKETS]; ///< Chunks con tamaño en (2^(b-1), 2^b]
+    double sortSecondsSum;                ///< Suma de tiempos de ordenamiento por chunk
+    double sortSecondsMax;                ///< Mayor tiempo de ordenamiento de un chunk
+    double spillSecondsSum;               ///< Suma de tiempos de escritura por chunk
+    double spillSecondsMax;               ///< Mayor tiempo de escritura de un chunk
+    int mergeFanIn;                       ///< Fan-in máximo de la fusión
+    int mergePasses;                      ///< Pasadas de la fusión
+    size_t mergeRuns;                     ///< Corridas de entrada a la fusión
+    uint64_t mergeRecords;                ///< Registros escritos en todas las pasadas
+    uint64_t mergeOutputRecords;          ///< Registros del archivo final
+    uint64_t mergeComparisons;            ///< Comparaciones del torneo
+
+    std::string exportPath;               ///< Archivo Prometheus (vacío = sin exportación)
+    int exportIntervalMs;                 ///< Período de exportación
+    std::thread exporter;                 ///< Hilo que reescribe el archivo Prometheus
+    std::condition_variable exportCv;     ///< Despierta al exportador para terminar
+    bool exportStopping;                  ///< Solicita al exportador terminar
+
+    RunMetrics(const RunMetrics&);            ///< No copiable
+    RunMetrics& operator=(const RunMetrics&); ///< No asignable
+
+    /**
+     * @brief Bucle del hilo exportador
+     */
+    void exportLoop();
+
+    /**
+     * @brief Actualiza sourceStats desde la fuente actual (requiere mtx)
+     */
+    void refreshSource();
+
+    /**
+     * @brief Duración de una fase hasta su fin o hasta ahora si sigue en curso (requiere mtx)
+     * @param phase Fase (1 o 2)
+     * @return Segundos transcurridos en la fase, 0 si no empezó
+     */
+    double phaseSeconds(int phase) const;
+
+    /**
+     * @brief Escribe el archivo Prometheus de forma atómica (temporal + rename)
+     */
+    void writeExportFile();
+
+public:
+    /**
+     * @brief Constructor; la ejecución se cronometra desde aquí
+     */
+    RunMetrics();
+
+    /**
+     * @brief Marca el inicio de una fase
+     * @param phase Fase (1 = adquisición, 2 = fusión)
+     */
+    void beginPhase(int phase);
+
+    /**
+     * @brief Marca el fin de una fase
+     * @param phase Fase (1 = adquisición, 2 = fusión)
+     */
+    void endPhase(int phase);
+
+    /**
+     * @brief Asocia la fuente cuyos contadores se exportan durante la Fase 1
+     * @param dataSource Fuente de datos (debe vivir hasta detachSource())
+     */
+    void attachSource(const DataSource* dataSource);
+
+    /**
+     * @brief Toma la última instantánea de la fuente y la desasocia
+     * @details Llamar antes de destruir la fuente
+     */
+    void detachSource();
+
+    /**
+     * @brief Registra un chunk escrito (seguro entre hilos)
+     * @param records Datos del chunk
+     * @param sortSeconds Tiempo de ordenamiento
+     * @param spillSeconds Tiempo de escritura
+     */
+    void recordChunk(uint64_t records, double sortSeconds, double spillSeconds);
+
+    /**
+     * @brief Registra el resultado de la Fase 2
+     * @param fanIn Fan-in máximo
+     * @param passes Pasadas ejecutadas
+     * @param runs Corridas de entrada
+     * @param recordsMerged Registros escritos en todas las pasadas
+     * @param outputRecords Registros del archivo final
+     * @param comparisons Comparaciones del torneo
+     */
+    void recordMerge(int fanIn, int passes, size_t runs, uint64_t recordsMerged,
+                     uint64_t outputRecords, uint64_t comparisons);
+
+    /**
+     * @brief Inicia la exportación periódica en formato Prometheus
+     * @param path Archivo a reescribir en cada período
+     * @param intervalMs Período en milisegundos
+     */
+    void startExport(const std::string& path, int intervalMs);
+
+    /**
+     * @brief Detiene la exportación periódica tras escribir una última vez
+     */
+    void stopExport();
+
+    /**
+     * @brief Escribe las métricas en formato de exposición de texto de Prometheus
+     * @param out Flujo de salida
+     */
+    void writePrometheus(std::ostream& out);
+
+    /**
+     * @brief Escribe las métricas como documento JSON
+     * @param out Flujo de salida
+     */
+    void writeJson(std::ostream& out);
+
+    /**
+     * @brief Escribe las métricas JSON en un archivo
+     * @param path Archivo de salida
+     * @return false si no se pudo escribir
+     */
+    bool writeJsonFile(const std::string& path);
+
+    /**
+     * @brief Memoria residente máxima del proceso
+     * @return Bytes (0 si la plataforma no lo informa)
+     */
+    static uint64_t peakMemoryBytes();
+
+    /**
+     * @brief Destructor; detiene la exportación si sigue activa
+     */
+    ~RunMetrics();
+};
+
+#endif
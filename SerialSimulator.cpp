@@ -0,0 +1,331 @@
+/**
+ * @file SerialSimulator.cpp
+ * @brief Simulador de dispositivo serial sobre un pseudo-terminal (PTY)
+ * @details Crea un par PTY con openpty() y transmite lecturas por el lado maestro en el
+ *          mismo formato que test.ino (Serial.println: "valor\r\n") o en tramas COBS como
+ *          test_cobs.ino. Permite probar SerialSource y las dos fases sin un Arduino.
+ *
+ * Uso: esort_sim [--count N] [--rate N] [--dist random|sorted|nearly|dups]
+ *                [--range MIN:MAX] [--noise P] [--protocol text|cobs] [--frame N]
+ *                [--seed N] [--delay MS] [--hold MS] [--link RUTA] [--dump ARCHIVO]
+ */
+
+#include "FrameCodec.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <pty.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @struct SimulatorOptions
+ * @brief Parámetros de la simulación
+ */
+struct SimulatorOptions {
+    long long count = 100000;     ///< Lecturas a enviar
+    double rate = 0;              ///< Lecturas por segundo (0 = tan rápido como acepte el PTY)
+    string distribution = "random"; ///< random, sorted, nearly o dups
+    int minValue = 0;             ///< Valor mínimo generado
+    int maxValue = 1000000;       ///< Valor máximo generado
+    double noise = 0;             ///< Probabilidad de dañar cada línea/trama
+    bool cobs = false;            ///< true para tramas COBS en lugar de texto
+    int frameReadings = 32;       ///< Lecturas por trama COBS
+    unsigned seed = 1;            ///< Semilla del generador
+    int delayMs = 2000;           ///< Espera antes de transmitir (para conectar el lector)
+    int holdMs = 500;             ///< Espera tras transmitir antes de cerrar el PTY
+    string link;                  ///< Enlace simbólico opcional al lado esclavo
+    string dump;                  ///< Archivo opcional con los valores enviados (sin ruido)
+};
+
+/**
+ * @brief Muestra la ayuda de la línea de comandos
+ */
+void printUsage() {
+    cerr << "Uso: esort_sim [--count N] [--rate N] [--dist random|sorted|nearly|dups]\n"
+         << "                [--range MIN:MAX] [--noise P] [--protocol text|cobs] [--frame N]\n"
+         << "                [--seed N] [--delay MS] [--hold MS] [--link RUTA] [--dump ARCHIVO]\n";
+}
+
+/**
+ * @brief Interpreta los argumentos de la línea de comandos
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @param options Opciones resultantes
+ * @return false si algún argumento es inválido
+ */
+bool parseOptions(int argc, char** argv, SimulatorOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) {
+            cerr << "Error: Falta el valor de " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+
+        if (arg == "--count") options.count = atoll(value.c_str());
+        else if (arg == "--rate") options.rate = atof(value.c_str());
+        else if (arg == "--dist") options.distribution = value;
+        else if (arg == "--noise") options.noise = atof(value.c_str());
+        else if (arg == "--frame") options.frameReadings = atoi(value.c_str());
+        else if (arg == "--seed") options.seed = static_cast<unsigned>(atol(value.c_str()));
+        else if (arg == "--delay") options.delayMs = atoi(value.c_str());
+        else if (arg == "--hold") options.holdMs = atoi(value.c_str());
+        else if (arg == "--link") options.link = value;
+        else if (arg == "--dump") options.dump = value;
+        else if (arg == "--protocol") {
+            if (value != "text" && value != "cobs") return false;
+            options.cobs = (value == "cobs");
+        } else if (arg == "--range") {
+            size_t colon = value.find(':');
+            if (colon == string::npos) return false;
+            options.minValue = atoi(value.substr(0, colon).c_str());
+            options.maxValue = atoi(value.substr(colon + 1).c_str());
+        } else {
+            cerr << "Error: Opción desconocida " << arg << endl;
+            return false;
+        }
+    }
+
+    if (options.distribution != "random" && options.distribution != "sorted" &&
+        options.distribution != "nearly" && options.distribution != "dups") {
+        cerr << "Error: Distribución desconocida " << options.distribution << endl;
+        return false;
+    }
+    if (options.minValue > options.maxValue || options.frameReadings < 1 ||
+        options.frameReadings > FRAME_MAX_READINGS) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @class ReadingGenerator
+ * @brief Genera lecturas según la distribución elegida
+ */
+class ReadingGenerator {
+private:
+    const SimulatorOptions& options; ///< Parámetros de la simulación
+    mt19937 rng;                     ///< Generador pseudoaleatorio
+    long long index;                 ///< Lecturas generadas hasta ahora
+    vector<int> palette;             ///< Valores posibles en la distribución dups
+
+public:
+    /**
+     * @brief Constructor
+     * @param opts Parámetros de la simulación
+     */
+    ReadingGenerator(const SimulatorOptions& opts) : options(opts), rng(opts.seed), index(0) {
+        uniform_int_distribution<int> any(options.minValue, options.maxValue);
+        for (int i = 0; i < 16; i++) {
+            palette.push_back(any(rng));
+        }
+    }
+
+    /**
+     * @brief Genera la siguiente lectura
+     * @return Valor generado
+     */
+    int next() {
+        long long span = static_cast<long long>(options.maxValue) - options.minValue;
+        long long i = index++;
+        long long position = options.count > 1 ? span * i / (options.count - 1) : 0;
+
+        if (options.distribution == "sorted") {
+            return static_cast<int>(options.minValue + position);
+        }
+        if (options.distribution == "nearly") {
+            // Tendencia creciente con jitter de ±1% del rango
+            long long jitter = span / 100 + 1;
+            long long value = options.minValue + position +
+                              static_cast<long long>(rng() % (2 * jitter + 1)) - jitter;
+            if (value < options.minValue) value = options.minValue;
+            if (value > options.maxValue) value = options.maxValue;
+            return static_cast<int>(value);
+        }
+        if (options.distribution == "dups") {
+            return palette[rng() % palette.size()];
+        }
+        return uniform_int_distribution<int>(options.minValue, options.maxValue)(rng);
+    }
+
+    /**
+     * @brief Decide si se daña el siguiente mensaje
+     * @return true con probabilidad options.noise
+     */
+    bool corrupt() {
+        return options.noise > 0 && uniform_real_distribution<double>(0, 1)(rng) < options.noise;
+    }
+
+    /**
+     * @brief Devuelve un byte aleatorio para el ruido
+     * @return Byte aleatorio
+     */
+    uint8_t randomByte() {
+        return static_cast<uint8_t>(rng());
+    }
+};
+
+/**
+ * @brief Escribe todos los bytes en el lado maestro del PTY
+ * @param fd Descriptor del lado maestro
+ * @param data Bytes a escribir
+ * @param size Número de bytes
+ * @return false si el PTY se cerró
+ */
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SimulatorOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    int master;
+    int slave;
+    char slaveName[256];
+    if (openpty(&master, &slave, slaveName, NULL, NULL) != 0) {
+        cerr << "Error: No se pudo crear el pseudo-terminal" << endl;
+        return 1;
+    }
+
+    // El lado esclavo queda abierto para que los datos no se pierdan antes de que
+    // el lector se conecte; se configura en modo crudo como un puerto real
+    struct termios tty;
+    tcgetattr(slave, &tty);
+    cfmakeraw(&tty);
+    tcsetattr(slave, TCSANOW, &tty);
+
+    if (!options.link.empty()) {
+        unlink(options.link.c_str());
+        if (symlink(slaveName, options.link.c_str()) != 0) {
+            cerr << "Advertencia: No se pudo crear el enlace " << options.link << endl;
+        }
+    }
+
+    cout << "Dispositivo simulado: " << slaveName;
+    if (!options.link.empty()) cout << " (" << options.link << ")";
+    cout << endl;
+    cout << "Enviando " << options.count << " lecturas (" << options.distribution << ", "
+         << (options.cobs ? "cobs" : "text") << ") en " << options.delayMs << " ms..." << endl;
+
+    this_thread::sleep_for(chrono::milliseconds(options.delayMs));
+
+    ReadingGenerator generator(options);
+    ofstream dumpFile;
+    if (!options.dump.empty()) {
+        dumpFile.open(options.dump);
+    }
+
+    vector<uint8_t> out;
+    out.reserve(1 << 16);
+    int32_t frame[FRAME_MAX_READINGS];
+    int frameCount = 0;
+    long long sent = 0;
+    long long damaged = 0;
+    long long sum = 0;
+
+    auto start = chrono::steady_clock::now();
+    bool open = true;
+
+    for (long long i = 0; i < options.count && open; i++) {
+        int value = generator.next();
+        sum += value;
+        if (dumpFile.is_open()) dumpFile << value << '\n';
+
+        if (options.cobs) {
+            frame[frameCount++] = value;
+            if (frameCount == options.frameReadings || i + 1 == options.count) {
+                uint8_t encoded[FRAME_MAX_ENCODED];
+                size_t size = encodeFrame(frame, frameCount, encoded);
+                if (generator.corrupt()) {
+                    // Un byte distinto de 0x00 dentro de la trama: falla COBS o el CRC
+                    size_t pos = generator.randomByte() % (size - 1);
+                    encoded[pos] ^= static_cast<uint8_t>(1 + generator.randomByte() % 255);
+                    if (encoded[pos] == 0) encoded[pos] = 0x5A;
+                    damaged++;
+                }
+                out.insert(out.end(), encoded, encoded + size);
+                frameCount = 0;
+            }
+        } else {
+            char line[16];
+            int len = snprintf(line, sizeof(line), "%d\r\n", value);
+            if (generator.corrupt()) {
+                // Ruido de línea: un carácter basura dentro del número (SerialSource
+                // descarta la lectura entera) o una línea extra sin dígitos antes de ella
+                if (generator.randomByte() & 1) {
+                    line[generator.randomByte() % (len - 2)] = static_cast<char>('a' + generator.randomByte() % 26);
+                } else {
+                    static const char garbage[] = "#?~*%&\r\n";
+                    out.insert(out.end(), garbage, garbage + sizeof(garbage) - 1);
+                }
+                damaged++;
+            }
+            out.insert(out.end(), line, line + len);
+        }
+        sent++;
+
+        // Ritmo: si hay tasa objetivo, esperar hasta el instante de la lectura i+1
+        bool flushNow = out.size() >= (1 << 15) || i + 1 == options.count;
+        if (options.rate > 0) {
+            auto target = start + chrono::duration<double>((i + 1) / options.rate);
+            if (target > chrono::steady_clock::now() + chrono::milliseconds(1)) {
+                flushNow = true;
+            }
+            if (flushNow) {
+                open = writeAll(master, out.data(), out.size());
+                out.clear();
+                this_thread::sleep_until(target);
+            }
+        } else if (flushNow) {
+            open = writeAll(master, out.data(), out.size());
+            out.clear();
+        }
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Enviadas " << sent << " lecturas en " << seconds << " s ("
+         << (seconds > 0 ? sent / seconds : 0) << " lecturas/s), dañadas: " << damaged
+         << ", suma: " << sum << endl;
+
+    // Cerrar el maestro descarta lo que el lector aún no consumió: esperar a que
+    // la cola de entrada del esclavo se vacíe antes de la pausa final
+    int unread = 0;
+    while (open && ioctl(slave, FIONREAD, &unread) == 0 && unread > 0) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    this_thread::sleep_for(chrono::milliseconds(options.holdMs));
+    if (!options.link.empty()) {
+        unlink(options.link.c_str());
+    }
+    close(slave);
+    close(master);
+    return open ? 0 : 1;
+}
@@ -4,13 +4,22 @@
  */
 
 #include "SerialSource.h"
+#include <cstring>
 #include <iostream>
-#include <sstream>
+
+#ifndef _WIN32
+    #include <cerrno>
+#endif
 
 #ifdef _WIN32
 // ============= IMPLEMENTACIÓN WINDOWS =============
-SerialSource::SerialSource(const std::string& port, int baudRate)
-    : connected(false), dataAvailable(true), timeoutCounter(0) {
+SerialSource::SerialSource(const std::string& port, int baudRate, int idleTimeout,
+                           SerialProtocol serialProtocol)
+    : ring(new char[RING_SIZE]), ringHead(0), ringTail(0), scanPos(0),
+      connected(false), dataAvailable(true), timeoutCounter(0), idleTimeoutMs(idleTimeout),
+      protocol(serialProtocol), pendingCount(0), pendingPos(0), invalidLines(0),
+      corruptFrames(0), recordCount(0), bytesRead(0),
+      invalidLog(INVALID_LOG_PER_SECOND, 1000), opened(false), ioFailed(false) {
     std::wstring widePort(port.begin(), port.end());
 
     hSerial = CreateFileW(
@@ -43,15 +52,34 @@ SerialSource::SerialSource(const std::string& port, int baudRate)
     dcbSerialParams.Parity = NOPARITY;
 
     if (!SetCommState(hSerial, &dcbSerialParams)) {
-        std::cerr << "Error: No se pudo configurar el puerto" << std::endl;
+        // El driver rechaza las velocidades que no soporta (ERROR_INVALID_PARAMETER)
+        std::cerr << "Error: No se pudo configurar el puerto a " << baudRate << " baudios"
+                  << std::endl;
         CloseHandle(hSerial);
+        hSerial = INVALID_HANDLE_VALUE;
         return;
     }
 
+    // Algunos drivers aceptan la velocidad y la redondean: como en POSIX (toSpeed), una
+    // velocidad distinta de la pedida solo produciría basura y la fuente queda en IO_ERROR
+    DCB applied = {0};
+    applied.DCBlength = sizeof(applied);
+    if (!GetCommState(hSerial, &applied) || applied.BaudRate != static_cast<DWORD>(baudRate)) {
+        std::cerr << "Error: Velocidad " << baudRate << " no soportada por el sistema"
+                  << std::endl;
+        CloseHandle(hSerial);
+        hSerial = INVALID_HANDLE_VALUE;
+        return;
+    }
+
+    // Buffer de entrada del driver amplio para velocidades altas
+    SetupComm(hSerial, RING_SIZE, 4096);
+
+    // ReadFile devuelve en cuanto hay algún byte, o tras POLL_SLICE_MS sin datos
     COMMTIMEOUTS timeouts = {0};
-    timeouts.ReadIntervalTimeout = 100;
-    timeouts.ReadTotalTimeoutConstant = 100;
-    timeouts.ReadTotalTimeoutMultiplier = 10;
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+    timeouts.ReadTotalTimeoutConstant = POLL_SLICE_MS;
 
     if (!SetCommTimeouts(hSerial, &timeouts)) {
         std::cerr << "Error: No se pudieron configurar los timeouts" << std::endl;
@@ -60,28 +88,96 @@ SerialSource::SerialSource(const std::string& port, int baudRate)
     }
 
     connected = true;
+    opened = true;
     std::cout << "Conectado exitosamente" << std::endl;
 }
 
-bool SerialSource::readChar(char& c) {
-    DWORD bytesRead;
-    if (!ReadFile(hSerial, &c, 1, &bytesRead, NULL)) {
+size_t SerialSource::fillRing() {
+    size_t used = ringTail - ringHead;
+    size_t offset = ringTail & (RING_SIZE - 1);
+    size_t contiguous = RING_SIZE - offset;
+    if (contiguous > RING_SIZE - used) contiguous = RING_SIZE - used;
+
+    DWORD received = 0;
+    if (!ReadFile(hSerial, ring + offset, static_cast<DWORD>(contiguous), &received, NULL)) {
+        std::cerr << "Error: Falló la lectura del puerto (código " << GetLastError() << ")"
+                  << std::endl;
         connected = false;
-        return false;
+        ioFailed = true;
+        return 0;
     }
-    return bytesRead > 0;
+
+    ringTail += received;
+    bytesRead.fetch_add(received, std::memory_order_relaxed);
+    return received;
 }
 
 SerialSource::~SerialSource() {
     if (connected && hSerial != INVALID_HANDLE_VALUE) {
         CloseHandle(hSerial);
     }
+    delete[] ring;
 }
 
 #else
 // ============= IMPLEMENTACIÓN LINUX =============
-SerialSource::SerialSource(const std::string& port, int baudRate)
-    : connected(false), dataAvailable(true), timeoutCounter(0) {
+bool SerialSource::toSpeed(int baudRate, speed_t& speed) {
+    switch (baudRate) {
+        case 9600:    speed = B9600; return true;
+        case 19200:   speed = B19200; return true;
+        case 38400:   speed = B38400; return true;
+        case 57600:   speed = B57600; return true;
+        case 115200:  speed = B115200; return true;
+#ifdef B230400
+        case 230400:  speed = B230400; return true;
+#endif
+#ifdef B460800
+        case 460800:  speed = B460800; return true;
+#endif
+#ifdef B500000
+        case 500000:  speed = B500000; return true;
+#endif
+#ifdef B576000
+        case 576000:  speed = B576000; return true;
+#endif
+#ifdef B921600
+        case 921600:  speed = B921600; return true;
+#endif
+#ifdef B1000000
+        case 1000000: speed = B1000000; return true;
+#endif
+#ifdef B1152000
+        case 1152000: speed = B1152000; return true;
+#endif
+#ifdef B1500000
+        case 1500000: speed = B1500000; return true;
+#endif
+#ifdef B2000000
+        case 2000000: speed = B2000000; return true;
+#endif
+#ifdef B2500000
+        case 2500000: speed = B2500000; return true;
+#endif
+#ifdef B3000000
+        case 3000000: speed = B3000000; return true;
+#endif
+#ifdef B3500000
+        case 3500000: speed = B3500000; return true;
+#endif
+#ifdef B4000000
+        case 4000000: speed = B4000000; return true;
+#endif
+        default:      return false;
+    }
+}
+
+SerialSource::SerialSource(const std::string& port, int baudRate, int idleTimeout,
+                           SerialProtocol serialProtocol)
+    : ring(new char[RING_SIZE]), ringHead(0), ringTail(0), scanPos(0),
+      connected(false), dataAvailable(true), timeoutCounter(0), idleTimeoutMs(idleTimeout),
+      protocol(serialProtocol), pendingCount(0), pendingPos(0), invalidLines(0),
+      corruptFrames(0), recordCount(0), bytesRead(0),
+      invalidLog(INVALID_LOG_PER_SECOND, 1000), opened(false), ioFailed(false) {
     fd = open(port.c_str(), O_RDWR | O_NOCTTY);
 
     if (fd == -1) {
@@ -93,14 +189,18 @@ SerialSource::SerialSource(const std::string& port, int baudRate)
     if (tcgetattr(fd, &tty) != 0) {
         std::cerr << "Error: No se pudo obtener atributos del puerto" << std::endl;
         close(fd);
+        fd = -1;
         return;
     }
 
     speed_t speed;
-    switch(baudRate) {
-        case 9600:   speed = B9600; break;
-        case 115200: speed = B115200; break;
-        default:     speed = B9600;
+    if (!toSpeed(baudRate, speed)) {
+        // Abrir a otra velocidad solo produciría basura: la fuente queda en IO_ERROR
+        std::cerr << "Error: Velocidad " << baudRate << " no soportada por el sistema"
+                  << std::endl;
+        close(fd);
+        fd = -1;
+        return;
     }
 
     cfsetospeed(&tty, speed);
@@ -125,90 +225,289 @@ SerialSource::SerialSource(const std::string& port, int baudRate)
     tty.c_oflag &= ~OPOST;
     tty.c_oflag &= ~ONLCR;
 
-    tty.c_cc[VTIME] = 1;
+    // Lectura no bloqueante: la espera la hace poll() en fillRing()
+    tty.c_cc[VTIME] = 0;
     tty.c_cc[VMIN] = 0;
 
     if (tcsetattr(fd, TCSANOW, &tty) != 0) {
         std::cerr << "Error: No se pudieron configurar atributos" << std::endl;
         close(fd);
+        fd = -1;
         return;
     }
 
     connected = true;
+    opened = true;
     std::cout << "Conectado exitosamente" << std::endl;
 }
 
-bool SerialSource::readChar(char& c) {
-    int n = read(fd, &c, 1);
+size_t SerialSource::fillRing() {
+    size_t used = ringTail - ringHead;
+    size_t offset = ringTail & (RING_SIZE - 1);
+    size_t contiguous = RING_SIZE - offset;
+    if (contiguous > RING_SIZE - used) contiguous = RING_SIZE - used;
+
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ready = poll(&pfd, 1, POLL_SLICE_MS);
+    if (ready < 0) {
+        if (errno != EINTR) {
+            std::cerr << "Error: Falló la espera del puerto: " << std::strerror(errno) << std::endl;
+            connected = false;
+            ioFailed = true;
+        }
+        return 0;
+    }
+    if (ready == 0) {
+        return 0;
+    }
+
+    ssize_t n = ::read(fd, ring + offset, contiguous);
     if (n < 0) {
+        if (errno != EINTR && errno != EAGAIN) {
+            std::cerr << "Error: Falló la lectura del puerto: " << std::strerror(errno) << std::endl;
+            connected = false;
+            ioFailed = true;
+        }
+        return 0;
+    }
+    if (n == 0) {
+        // poll indicó datos pero read no devolvió nada: el otro extremo colgó
         connected = false;
-        return false;
+        return 0;
     }
-    return n > 0;
+
+    ringTail += n;
+    bytesRead.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+    return static_cast<size_t>(n);
 }
 
 SerialSource::~SerialSource() {
-    if (connected && fd != -1) {
+    if (fd != -1) {
         close(fd);
     }
+    delete[] ring;
 }
 #endif
 
 // ============= FUNCIONES COMUNES =============
-bool SerialSource::readLine(std::string& line) {
-    if (!connected) return false;
-
-    line.clear();
-    char c;
-    int emptyReads = 0;
-    const int MAX_EMPTY_READS = 100;
-
-    while (emptyReads < MAX_EMPTY_READS) {
-        if (readChar(c)) {
-            emptyReads = 0;
-
-            if (c == '\n') {
-                if (!line.empty()) {
-                    return true;
-                }
-            } else if (c == '\r') {
-                // Ignorar \r
-                continue;
-            } else if ((c >= '0' && c <= '9') || c == '-' || c == ' ') {
-                line += c;
+bool SerialSource::waitRecord(char delimiter, size_t& end, bool wait) {
+    int silentMs = 0;
+
+    while (true) {
+        // Buscar el delimitador solo en los bytes que aún no se revisaron
+        while (scanPos != ringTail) {
+            char c = ring[scanPos & (RING_SIZE - 1)];
+            scanPos++;
+            if (c == delimiter) {
+                end = scanPos - 1;
+                return true;
             }
+        }
+
+        if (!connected || !wait) {
+            return false;
+        }
+
+        // Registro más largo que el buffer: se descarta como ruido
+        if (ringTail - ringHead == RING_SIZE) {
+            ringHead = scanPos = ringTail;
+        }
+
+        if (fillRing() > 0) {
+            silentMs = 0;
         } else {
-            emptyReads++;
+            silentMs += POLL_SLICE_MS;
+            if (silentMs >= idleTimeoutMs) {
+                return false;
+            }
         }
     }
+}
+
+bool SerialSource::readLine(std::string& line, bool wait) {
+    size_t end;
+    while (waitRecord('\n', end, wait)) {
+        line.clear();
+        // La línea se entrega completa: un carácter de ruido la invalida entera en
+        // parseLine() en lugar de quitarse y dejar otro número (12a4 no es 124)
+        for (size_t pos = ringHead; pos < end; pos++) {
+            char c = ring[pos & (RING_SIZE - 1)];
+            if (c != '\r') {
+                line += c;
+            }
+        }
+        ringHead = end + 1;
 
+        if (!line.empty()) {
+            return true;
+        }
+    }
     return false;
 }
 
-int SerialSource::getNext() {
-    if (!connected || !dataAvailable) {
-        return 0;
+bool SerialSource::readFrame(bool wait) {
+    size_t end;
+    if (!waitRecord('\0', end, wait)) {
+        return false;
     }
 
-    std::string line;
-    if (readLine(line)) {
-        timeoutCounter = 0;
-        try {
-            int value = std::stoi(line);
-            return value;
-        } catch (...) {
-            std::cerr << "Error: Dato inválido recibido: " << line << std::endl;
-            return getNext();
+    size_t size = end - ringHead;
+    bool valid = size > 0 && size <= FRAME_MAX_ENCODED;
+
+    if (valid) {
+        uint8_t encoded[FRAME_MAX_ENCODED];
+        uint8_t payload[FRAME_MAX_ENCODED];
+        for (size_t i = 0; i < size; i++) {
+            encoded[i] = static_cast<uint8_t>(ring[(ringHead + i) & (RING_SIZE - 1)]);
         }
-    } else {
+
+        size_t payloadSize = 0;
+        valid = cobsDecode(encoded, size, payload, payloadSize) &&
+                parseFramePayload(payload, payloadSize, pending, pendingCount);
+    }
+    ringHead = end + 1;
+
+    if (valid) {
+        pendingPos = 0;
+    } else if (size > 0) {
+        // Un 0x00 suelto solo separa tramas; cualquier otra cosa es una trama dañada
+        corruptFrames++;
+    }
+    return true;
+}
+
+bool SerialSource::parseLine(const std::string& line, int& value) {
+    size_t i = 0;
+    while (i < line.size() && line[i] == ' ') i++;
+
+    bool negative = false;
+    if (i < line.size() && line[i] == '-') {
+        negative = true;
+        i++;
+    }
+
+    long long acc = 0;
+    size_t digits = 0;
+    while (i < line.size() && line[i] >= '0' && line[i] <= '9') {
+        acc = acc * 10 + (line[i] - '0');
+        if (acc > 2147483648LL) return false;
+        i++;
+        digits++;
+    }
+    while (i < line.size() && line[i] == ' ') i++;
+
+    if (digits == 0 || i != line.size()) return false;
+    if (negative) acc = -acc;
+    if (acc > 2147483647LL) return false;
+
+    value = static_cast<int>(acc);
+    return true;
+}
+
+bool SerialSource::fetch(int& value, bool wait) {
+    while (dataAvailable) {
+        if (protocol == SerialProtocol::COBS) {
+            if (pendingPos < pendingCount) {
+                recordCount.fetch_add(1, std::memory_order_relaxed);
+                value = pending[pendingPos++];
+                return true;
+            }
+            if (readFrame(wait)) {
+                continue;
+            }
+        } else if (readLine(buffer, wait)) {
+            if (parseLine(buffer, value)) {
+                recordCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            invalidLines++;
+            // Un sensor con ruido no debe frenar la lectura: aviso con límite, el total
+            // queda en las métricas (invalid_lines)
+            uint64_t skipped = 0;
+            if (invalidLog.allow(skipped)) {
+                std::string message = "Dato inválido recibido: " + buffer;
+                if (skipped > 0) message += " (" + std::to_string(skipped) + " más sin informar)";
+                Logger::instance().write(LogLevel::WARN, message);
+            }
+            continue;
+        }
+
+        if (!wait) {
+            // Nada completo en el buffer; el fin se detecta en la próxima espera
+            return false;
+        }
+
+        // Sin datos durante idleTimeoutMs (o puerto cerrado): fin de la fuente
         timeoutCounter++;
-        if (timeoutCounter >= MAX_TIMEOUTS) {
-            dataAvailable = false;
+        dataAvailable = false;
+    }
+    return false;
+}
+
+int SerialSource::getNext() {
+    int value;
+    return fetch(value, true) ? value : 0;
+}
+
+size_t SerialSource::read(int* out, size_t max) {
+    size_t n = 0;
+    while (n < max) {
+        if (pendingPos < pendingCount) {
+            // Lecturas restantes de la trama actual, de una vez
+            size_t take = static_cast<size_t>(pendingCount - pendingPos);
+            if (take > max - n) take = max - n;
+            std::memcpy(out + n, pending + pendingPos, take * sizeof(int));
+            pendingPos += static_cast<int>(take);
+            recordCount.fetch_add(take, std::memory_order_relaxed);
+            n += take;
+            continue;
         }
-        return 0;
+        // Solo la primera lectura del lote espera al puerto
+        if (!fetch(out[n], n == 0)) {
+            break;
+        }
+        n++;
     }
+    return n;
+}
+
+ReadStatus SerialSource::getStatus() const {
+    if (!opened) {
+        return ReadStatus::IO_ERROR;
+    }
+    if (dataAvailable && (pendingPos < pendingCount || connected || ringHead != ringTail)) {
+        return ReadStatus::OK;
+    }
+    // Un error de lectura no es un fin limpio: la captura debe poder continuar
+    return ioFailed ? ReadStatus::IO_ERROR : ReadStatus::END_OF_DATA;
 }
 
 bool SerialSource::hasMoreData() {
-    return connected && dataAvailable;
-}
\ No newline at end of file
+    return dataAvailable && (pendingPos < pendingCount || connected || ringHead != ringTail);
+}
+
+uint64_t SerialSource::getInvalidLines() const {
+    return invalidLines;
+}
+
+uint64_t SerialSource::getCorruptFrames() const {
+    return corruptFrames;
+}
+
+int SerialSource::getTimeouts() const {
+    return timeoutCounter;
+}
+
+SourceStats SerialSource::getStats() const {
+    SourceStats stats;
+    stats.records = recordCount.load(std::memory_order_relaxed);
+    stats.bytes = bytesRead.load(std::memory_order_relaxed);
+    stats.timeouts = static_cast<uint64_t>(timeoutCounter.load(std::memory_order_relaxed));
+    stats.invalidLines = invalidLines.load(std::memory_order_relaxed);
+    stats.corruptFrames = corruptFrames.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -8,6 +8,10 @@
 #define SERIALSOURCE_H
 
 #include "DataSource.h"
+#include "FrameCodec.h"
+#include "Logger.h"
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 #ifdef _WIN32
@@ -16,13 +20,25 @@
     #include <termios.h>
     #include <fcntl.h>
     #include <unistd.h>
+    #include <poll.h>
     #include <sys/time.h>
 #endif
 
+/**
+ * @enum SerialProtocol
+ * @brief Formato de los datos que envía el dispositivo
+ */
+enum class SerialProtocol {
+    TEXT,   ///< Un entero ASCII por línea (Serial.println, ver test.ino)
+    COBS    ///< Tramas binarias COBS con varias lecturas y CRC-16 (ver test_cobs.ino)
+};
+
 /**
  * @class SerialSource
  * @brief Fuente de datos que lee desde puerto serial REAL (COM/tty)
- * @details Lee datos enteros línea por línea desde un puerto COM físico
+ * @details Lee del puerto en bloques de varios KB hacia un buffer circular interno
+ *          (esperando datos con poll/timeouts de WinAPI) y separa las líneas desde ahí,
+ *          en lugar de hacer una llamada al sistema por carácter
  */
 class SerialSource : public DataSource {
 private:
@@ -31,39 +47,116 @@ private:
 #else
     int fd;                ///< File descriptor del puerto serial en Linux
 #endif
-    std::string buffer;    ///< Buffer para acumular caracteres
+    static const size_t RING_SIZE = 1 << 16;  ///< Tamaño del buffer circular (potencia de dos)
+    static const int POLL_SLICE_MS = 100;     ///< Espera máxima de cada poll/ReadFile
+    static const uint32_t INVALID_LOG_PER_SECOND = 5; ///< Avisos de datos inválidos por segundo
+
+    char* ring;            ///< Buffer circular con los bytes recibidos
+    size_t ringHead;       ///< Posición (monótona) del siguiente byte a consumir
+    size_t ringTail;       ///< Posición (monótona) donde se escribe el siguiente byte
+    size_t scanPos;        ///< Hasta dónde ya se buscó '\n' sin encontrarlo
+    std::string buffer;    ///< Línea actual (se reutiliza para no reservar memoria)
     bool connected;        ///< Estado de conexión
     bool dataAvailable;    ///< Indica si hay datos disponibles
-    int timeoutCounter;    ///< Contador de timeouts consecutivos
-    static const int MAX_TIMEOUTS = 50; ///< Máximo de timeouts antes de considerar que no hay más datos
+    std::atomic<int> timeoutCounter; ///< Número de timeouts de lectura ocurridos
+    int idleTimeoutMs;     ///< Silencio máximo (ms) antes de considerar que no hay más datos
+    SerialProtocol protocol;          ///< Formato de los datos recibidos
+    int32_t pending[FRAME_MAX_READINGS]; ///< Lecturas de la última trama aún no entregadas
+    int pendingCount;      ///< Lecturas válidas en pending
+    int pendingPos;        ///< Siguiente lectura de pending a entregar
+    // Contadores atómicos: getStats() puede leerlos desde otro hilo
+    std::atomic<uint64_t> invalidLines;  ///< Líneas de texto descartadas por no ser un entero válido
+    std::atomic<uint64_t> corruptFrames; ///< Tramas descartadas por COBS, longitud o CRC inválidos
+    std::atomic<uint64_t> recordCount;   ///< Lecturas válidas entregadas por getNext()
+    std::atomic<uint64_t> bytesRead;     ///< Bytes recibidos del puerto
+    LogRateLimit invalidLog;             ///< Límite de los avisos de datos inválidos
+    bool opened;           ///< true si el puerto se abrió y configuró correctamente
+    bool ioFailed;         ///< poll/read (ReadFile) falló con el puerto abierto (ej: USB desconectado)
+
+    SerialSource(const SerialSource&);            ///< No copiable
+    SerialSource& operator=(const SerialSource&); ///< No asignable
+
+    /**
+     * @brief Espera datos hasta POLL_SLICE_MS y lee un bloque del puerto al buffer circular
+     * @return Número de bytes leídos (0 si hubo timeout o error)
+     * @details Lee de una vez todo el espacio contiguo libre del buffer (varios KB)
+     */
+    size_t fillRing();
+
+    /**
+     * @brief Busca el siguiente registro terminado en un delimitador, rellenando el buffer
+     * @param delimiter Byte que termina cada registro ('\n' o 0x00)
+     * @param end Posición (monótona) del delimitador encontrado
+     * @param wait false para buscar solo en los bytes ya recibidos, sin leer del puerto
+     * @return true si se encontró un registro, false si timeout, puerto cerrado o
+     *         (sin espera) no hay un registro completo en el buffer
+     * @details El registro ocupa [ringHead, end); el llamador lo consume con ringHead = end + 1
+     */
+    bool waitRecord(char delimiter, size_t& end, bool wait = true);
+
+    /**
+     * @brief Lee una línea completa del buffer circular, rellenándolo si hace falta
+     * @param line Referencia donde se almacenará la línea leída (sin '\r' ni '\n')
+     * @param wait false para no esperar datos nuevos del puerto
+     * @return true si se leyó una línea no vacía, false si timeout o error
+     */
+    bool readLine(std::string& line, bool wait = true);
+
+    /**
+     * @brief Lee y valida la siguiente trama COBS, dejando sus lecturas en pending
+     * @param wait false para no esperar datos nuevos del puerto
+     * @return true si se consumió una trama (válida o descartada), false si timeout o error
+     */
+    bool readFrame(bool wait = true);
+
+    /**
+     * @brief Obtiene la siguiente lectura válida
+     * @param value Lectura obtenida
+     * @param wait false para entregar solo lo que ya está en el buffer
+     * @return false al terminar la fuente (con espera) o si no hay nada completo (sin espera)
+     * @details Con espera, un timeout o desconexión marcan el fin de la fuente
+     */
+    bool fetch(int& value, bool wait);
 
     /**
-     * @brief Lee un carácter del puerto serial
-     * @param c Referencia donde se almacenará el carácter leído
-     * @return true si se leyó correctamente, false en caso de error
+     * @brief Convierte una línea a entero sin excepciones
+     * @param line Línea recibida
+     * @param value Valor convertido
+     * @return false si la línea no es un entero de 32 bits válido (solo admite espacios
+     *         alrededor, un '-' y dígitos: cualquier otro carácter la invalida)
      */
-    bool readChar(char& c);
+    static bool parseLine(const std::string& line, int& value);
 
+#ifndef _WIN32
     /**
-     * @brief Lee una línea completa del puerto serial con timeout
-     * @param line Referencia donde se almacenará la línea leída
-     * @return true si se leyó una línea válida, false si timeout o error
+     * @brief Traduce una velocidad numérica a la constante de termios
+     * @param baudRate Velocidad en baudios
+     * @param speed Constante speed_t correspondiente (sin cambios si no está soportada)
+     * @return false si la velocidad no está soportada por el sistema
      */
-    bool readLine(std::string& line);
+    static bool toSpeed(int baudRate, speed_t& speed);
+#endif
 
 public:
     /**
      * @brief Constructor que abre el puerto serial REAL
      * @param port Nombre del puerto serial (ej: "COM3" en Windows o "/dev/ttyUSB0" en Linux)
-     * @param baudRate Velocidad de comunicación (por defecto 9600)
-     * @details Conecta al puerto físico usando WinAPI o POSIX
+     * @param baudRate Velocidad de comunicación (por defecto 9600; hasta 4000000 en Linux)
+     * @param idleTimeout Milisegundos sin recibir datos antes de dar la fuente por terminada
+     * @param serialProtocol Formato de los datos (texto por líneas o tramas COBS)
+     * @details Conecta al puerto físico usando WinAPI o POSIX. Si el sistema no acepta
+     *          baudRate exacta (toSpeed en POSIX, SetCommState y la velocidad aplicada en
+     *          Windows) el puerto no se abre y getStatus() devuelve IO_ERROR
      */
-    SerialSource(const std::string& port, int baudRate = 9600);
+    SerialSource(const std::string& port, int baudRate = 9600, int idleTimeout = 2000,
+                 SerialProtocol serialProtocol = SerialProtocol::TEXT);
 
     /**
      * @brief Lee y devuelve el siguiente entero del serial
      * @return int Siguiente valor leído del puerto
-     * @details Lee caracteres hasta encontrar '\n' y convierte a entero
+     * @details En modo texto separa la siguiente línea del buffer circular y la convierte
+     *          a entero; en modo COBS entrega la siguiente lectura de la trama actual.
+     *          Las líneas inválidas y tramas corruptas se cuentan y se saltan.
      */
     int getNext() override;
 
@@ -73,6 +166,48 @@ public:
      */
     bool hasMoreData() override;
 
+    /**
+     * @brief Lee un lote de lecturas
+     * @param out Arreglo destino
+     * @param max Capacidad de out
+     * @return Lecturas obtenidas; 0 solo cuando la fuente terminó
+     * @details Espera (hasta idleTimeout) la primera lectura y luego entrega, sin volver
+     *          a esperar, todas las líneas o tramas completas que ya estén en el buffer
+     */
+    size_t read(int* out, size_t max) override;
+
+    /**
+     * @brief Estado de la fuente
+     * @return OK mientras haya datos, END_OF_DATA tras el timeout de inactividad o si el
+     *         otro extremo cerró, IO_ERROR si el puerto no pudo abrirse o una lectura
+     *         falló (poll/read con error, ej: EIO al desconectar el USB)
+     */
+    ReadStatus getStatus() const override;
+
+    /**
+     * @brief Obtiene el número de líneas de texto descartadas
+     * @return Líneas inválidas recibidas
+     */
+    uint64_t getInvalidLines() const;
+
+    /**
+     * @brief Obtiene el número de tramas COBS descartadas
+     * @return Tramas corruptas recibidas
+     */
+    uint64_t getCorruptFrames() const;
+
+    /**
+     * @brief Obtiene el número de timeouts de lectura
+     * @return Timeouts ocurridos
+     */
+    int getTimeouts() const;
+
+    /**
+     * @brief Obtiene lecturas, bytes, timeouts y descartes del puerto
+     * @return Contadores actuales
+     */
+    SourceStats getStats() const override;
+
     /**
      * @brief Destructor que cierra la conexión serial
      */
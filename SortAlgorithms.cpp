@@ -0,0 +1,38 @@
+/**
+ * @file SortAlgorithms.cpp
+ * @brief Versiones para int de los algoritmos de ordenamiento en memoria
+ */
+
+#include "SortAlgorithms.h"
+
+namespace {
+
+typedef KeyLess<IdentityKey<int> > IntLess;
+
+} // namespace
+
+void insertionSort(int* arr, int n) {
+    insertionSort(arr, n, IntLess());
+}
+
+void radixSort(int* arr, int n, int* aux) {
+    radixSort<IdentityKey<int> >(arr, n, aux);
+}
+
+void introSort(int* arr, int n) {
+    introSort(arr, n, IntLess());
+}
+
+void mergeSort(int* arr, int n, int* aux) {
+    mergeSort(arr, n, aux, IntLess());
+}
+
+const char* sortEngineName(SortEngine engine) {
+    switch (engine) {
+        case SortEngine::INSERTION: return "insertion";
+        case SortEngine::RADIX:     return "radix";
+        case SortEngine::INTRO:     return "intro";
+        case SortEngine::MERGE:     return "merge";
+    }
+    return "unknown";
+}
@@ -0,0 +1,291 @@
+/**
+ * @file SortAlgorithms.h
+ * @brief Algoritmos de ordenamiento en memoria usados por CircularBuffer
+ * @details Radix Sort LSD, Introsort, Merge Sort e Insertion Sort. Las plantillas
+ *          ordenan cualquier registro con un comparador (o, en Radix, con un extractor
+ *          de clave entera); las versiones para int las instancian con KeyLess.
+ */
+
+#ifndef SORTALGORITHMS_H
+#define SORTALGORITHMS_H
+
+#include "Record.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @enum SortEngine
+ * @brief Motor de ordenamiento seleccionable para los chunks en memoria
+ */
+enum class SortEngine {
+    INSERTION,  ///< Insertion Sort sobre la lista enlazada, O(n²)
+    RADIX,      ///< Radix Sort LSD de 8 bits por pasada, O(n)
+    INTRO,      ///< Introsort (Quicksort + Heapsort + Insertion Sort), O(n log n)
+    MERGE       ///< Merge Sort iterativo (bottom-up) estable, O(n log n)
+};
+
+namespace sortdetail {
+
+const int SMALL_PARTITION = 16; ///< Umbral para pasar a Insertion Sort en Introsort
+
+template<typename T, typename Compare>
+void siftDown(T* arr, int root, int n, Compare less) {
+    T value = arr[root];
+    while (true) {
+        int child = 2 * root + 1;
+        if (child >= n) break;
+        if (child + 1 < n && less(arr[child], arr[child + 1])) child++;
+        if (!less(value, arr[child])) break;
+        arr[root] = arr[child];
+        root = child;
+    }
+    arr[root] = value;
+}
+
+template<typename T, typename Compare>
+void heapSort(T* arr, int n, Compare less) {
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        sortdetail::siftDown(arr, i, n, less);
+    }
+    for (int end = n - 1; end > 0; end--) {
+        std::swap(arr[0], arr[end]);
+        sortdetail::siftDown(arr, 0, end, less);
+    }
+}
+
+template<typename T, typename Compare>
+void insertionSort(T* arr, int n, Compare less) {
+    for (int i = 1; i < n; i++) {
+        T key = arr[i];
+        int j = i - 1;
+        while (j >= 0 && less(key, arr[j])) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+template<typename T, typename Compare>
+void introSortLoop(T* arr, int n, int depthLimit, Compare less) {
+    while (n > SMALL_PARTITION) {
+        if (depthLimit == 0) {
+            sortdetail::heapSort(arr, n, less);
+            return;
+        }
+        depthLimit--;
+
+        // Mediana de tres: deja el pivote en arr[0]
+        int mid = n / 2;
+        if (less(arr[mid], arr[0])) std::swap(arr[mid], arr[0]);
+        if (less(arr[n - 1], arr[0])) std::swap(arr[n - 1], arr[0]);
+        if (less(arr[n - 1], arr[mid])) std::swap(arr[n - 1], arr[mid]);
+        std::swap(arr[0], arr[mid]);
+        T pivot = arr[0];
+
+        // Partición de Hoare
+        int i = 0;
+        int j = n;
+        while (true) {
+            do { i++; } while (i < n && less(arr[i], pivot));
+            do { j--; } while (less(pivot, arr[j]));
+            if (i >= j) break;
+            std::swap(arr[i], arr[j]);
+        }
+        std::swap(arr[0], arr[j]);
+
+        // Recursión en la parte menor, iteración en la mayor
+        int leftSize = j;
+        int rightSize = n - j - 1;
+        if (leftSize < rightSize) {
+            introSortLoop(arr, leftSize, depthLimit, less);
+            arr += j + 1;
+            n = rightSize;
+        } else {
+            introSortLoop(arr + j + 1, rightSize, depthLimit, less);
+            n = leftSize;
+        }
+    }
+    sortdetail::insertionSort(arr, n, less);
+}
+
+} // namespace sortdetail
+
+/**
+ * @brief Ordena un arreglo con Insertion Sort
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ * @param less Comparador estricto
+ */
+template<typename T, typename Compare>
+void insertionSort(T* arr, int n, Compare less) {
+    sortdetail::insertionSort(arr, n, less);
+}
+
+/**
+ * @brief Ordena un arreglo con Radix Sort LSD (base 256) sobre la clave de cada registro
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ * @param aux Arreglo auxiliar de al menos n elementos
+ * @details KeyOf::KeyType debe ser entero; se hacen sizeof(clave) pasadas, omitiendo
+ *          aquellas en las que todos los datos comparten el byte. Es estable, así que
+ *          los registros con igual clave conservan su orden de llegada.
+ */
+template<typename KeyOf, typename T>
+void radixSort(T* arr, int n, T* aux) {
+    typedef RadixKey<typename KeyOf::KeyType> Radix;
+    typedef typename Radix::Bits Bits;
+    const int PASSES = sizeof(Bits);
+
+    if (n <= 1) return;
+
+    // Histogramas de todos los bytes en un solo recorrido: la distribución de cada
+    // byte no cambia al permutar, así que las pasadas solo leen para distribuir
+    unsigned int count[PASSES][256];
+    std::memset(count, 0, sizeof(count));
+    for (int i = 0; i < n; i++) {
+        Bits bits = Radix::bits(KeyOf::key(arr[i]));
+        for (int pass = 0; pass < PASSES; pass++) {
+            count[pass][(bits >> (8 * pass)) & 0xFF]++;
+        }
+    }
+
+    T* src = arr;
+    T* dst = aux;
+    Bits first = Radix::bits(KeyOf::key(arr[0]));
+
+    for (int pass = 0; pass < PASSES; pass++) {
+        unsigned int shift = 8 * pass;
+        unsigned int* bucket = count[pass];
+
+        // Todos los datos comparten este byte: la pasada no cambia el orden
+        if (bucket[(first >> shift) & 0xFF] == static_cast<unsigned int>(n)) {
+            continue;
+        }
+
+        unsigned int offset = 0;
+        for (int b = 0; b < 256; b++) {
+            unsigned int c = bucket[b];
+            bucket[b] = offset;
+            offset += c;
+        }
+
+        for (int i = 0; i < n; i++) {
+            dst[bucket[(Radix::bits(KeyOf::key(src[i])) >> shift) & 0xFF]++] = src[i];
+        }
+
+        T* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != arr) {
+        std::copy(src, src + n, arr);
+    }
+}
+
+/**
+ * @brief Ordena un arreglo con Introsort
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ * @param less Comparador estricto
+ * @details Quicksort con mediana de tres; cambia a Heapsort si la recursión
+ *          excede 2*log2(n) y usa Insertion Sort en particiones pequeñas
+ */
+template<typename T, typename Compare>
+void introSort(T* arr, int n, Compare less) {
+    if (n <= 1) return;
+
+    int depthLimit = 0;
+    for (int m = n; m > 1; m >>= 1) {
+        depthLimit++;
+    }
+    sortdetail::introSortLoop(arr, n, 2 * depthLimit, less);
+}
+
+/**
+ * @brief Ordena un arreglo con Merge Sort iterativo (estable)
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ * @param aux Arreglo auxiliar de al menos n elementos
+ * @param less Comparador estricto
+ */
+template<typename T, typename Compare>
+void mergeSort(T* arr, int n, T* aux, Compare less) {
+    const int run = sortdetail::SMALL_PARTITION;
+    if (n <= 1) return;
+
+    // Corridas iniciales de SMALL_PARTITION elementos ordenadas con Insertion Sort
+    for (int start = 0; start < n; start += run) {
+        int len = n - start < run ? n - start : run;
+        sortdetail::insertionSort(arr + start, len, less);
+    }
+
+    T* src = arr;
+    T* dst = aux;
+
+    for (int width = run; width < n; width *= 2) {
+        for (int left = 0; left < n; left += 2 * width) {
+            int mid = left + width < n ? left + width : n;
+            int right = left + 2 * width < n ? left + 2 * width : n;
+
+            int i = left;
+            int j = mid;
+            int k = left;
+            while (i < mid && j < right) {
+                dst[k++] = less(src[j], src[i]) ? src[j++] : src[i++];
+            }
+            while (i < mid) dst[k++] = src[i++];
+            while (j < right) dst[k++] = src[j++];
+        }
+
+        T* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != arr) {
+        std::copy(src, src + n, arr);
+    }
+}
+
+/**
+ * @brief Ordena un arreglo de enteros con Insertion Sort
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ */
+void insertionSort(int* arr, int n);
+
+/**
+ * @brief Ordena un arreglo de enteros con Radix Sort LSD (base 256)
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ * @param aux Arreglo auxiliar de al menos n elementos
+ * @details Invierte el bit de signo para ordenar negativos correctamente y
+ *          omite las pasadas en las que todos los datos comparten el byte
+ */
+void radixSort(int* arr, int n, int* aux);
+
+/**
+ * @brief Ordena un arreglo de enteros con Introsort
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ */
+void introSort(int* arr, int n);
+
+/**
+ * @brief Ordena un arreglo de enteros con Merge Sort iterativo
+ * @param arr Arreglo a ordenar
+ * @param n Número de elementos
+ * @param aux Arreglo auxiliar de al menos n elementos
+ */
+void mergeSort(int* arr, int n, int* aux);
+
+/**
+ * @brief Devuelve el nombre legible de un motor de ordenamiento
+ * @param engine Motor de ordenamiento
+ * @return Nombre del motor (ej: "radix")
+ */
+const char* sortEngineName(SortEngine engine);
+
+#endif
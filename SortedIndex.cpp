@@ -0,0 +1,187 @@
+/**
+ * @file SortedIndex.cpp
+ * @brief Implementación de SortedIndexWriter y SortedIndex
+ */
+
+#include "SortedIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+// ============= SORTEDINDEXWRITER =============
+SortedIndexWriter::SortedIndexWriter()
+    : interval(0), recordWidth(0), count(0), distinct(0), minKey(0), lastKey(0), sum(0) {}
+
+void SortedIndexWriter::reset(uint32_t everyRecords, uint16_t width) {
+    interval = everyRecords;
+    recordWidth = width;
+    entries.clear();
+    count = 0;
+    distinct = 0;
+    minKey = 0;
+    lastKey = 0;
+    sum = 0;
+}
+
+bool SortedIndexWriter::write(const std::string& filename, uint64_t dataBytes) const {
+    SortedIndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SORTED_INDEX_MAGIC, sizeof(header.magic));
+    header.version = SORTED_INDEX_VERSION;
+    header.recordWidth = recordWidth;
+    header.interval = interval;
+    header.count = count;
+    header.distinct = distinct;
+    header.minKey = minKey;
+    header.maxKey = lastKey;
+    header.mean = count > 0 ? sum / static_cast<double>(count) : 0;
+    header.dataBytes = dataBytes;
+    header.entries = entries.size();
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: No se pudo crear el índice " << filename << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!entries.empty()) {
+        file.write(reinterpret_cast<const char*>(entries.data()),
+                   entries.size() * sizeof(SortedIndexEntry));
+    }
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Error: Falló la escritura del índice " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ============= SORTEDINDEX =============
+SortedIndex::SortedIndex() : seeks(0) {
+    std::memset(&header, 0, sizeof(header));
+}
+
+bool SortedIndex::open(const std::string& dataFile, const std::string& indexFile) {
+    std::string indexName = indexFile.empty() ? dataFile + SORTED_INDEX_SUFFIX : indexFile;
+
+    std::ifstream index(indexName, std::ios::binary);
+    if (!index.is_open()) {
+        std::cerr << "Error: No se pudo abrir el índice " << indexName << std::endl;
+        return false;
+    }
+    if (!index.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, SORTED_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SORTED_INDEX_VERSION || header.interval == 0) {
+        std::cerr << "Error: " << indexName << " no es un índice válido" << std::endl;
+        return false;
+    }
+    if (header.recordWidth != sizeof(int)) {
+        std::cerr << "Error: " << indexName << " indexa registros de " << header.recordWidth
+                  << " bytes; solo se consultan salidas de enteros" << std::endl;
+        return false;
+    }
+    if (header.entries != (header.count + header.interval - 1) / header.interval) {
+        std::cerr << "Error: " << indexName << " está incompleto" << std::endl;
+        return false;
+    }
+
+    entries.resize(static_cast<size_t>(header.entries));
+    if (!entries.empty() &&
+        !index.read(reinterpret_cast<char*>(entries.data()),
+                    entries.size() * sizeof(SortedIndexEntry))) {
+        std::cerr << "Error: " << indexName << " está truncado" << std::endl;
+        return false;
+    }
+
+    // Binario: los desplazamientos son bytes exactos también en Windows (\r\n)
+    data.open(dataFile, std::ios::binary);
+    if (!data.is_open()) {
+        std::cerr << "Error: No se pudo abrir " << dataFile << std::endl;
+        return false;
+    }
+    data.seekg(0, std::ios::end);
+    uint64_t size = static_cast<uint64_t>(data.tellg());
+    if (size != header.dataBytes) {
+        std::cerr << "Error: " << indexName << " no corresponde a " << dataFile
+                  << " (el archivo cambió después de indexarse)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SortedIndex::seekFirstNotBelow(int64_t key, uint64_t& position, uint64_t& offset) {
+    // Entradas con clave < key: el primer registro >= key está después de la última
+    std::vector<SortedIndexEntry>::const_iterator it =
+        std::lower_bound(entries.begin(), entries.end(), key,
+                         [](const SortedIndexEntry& e, int64_t k) { return e.key < k; });
+    size_t below = static_cast<size_t>(it - entries.begin());
+    if (below == 0) {
+        position = 0;
+        offset = entries.empty() ? header.dataBytes : entries[0].offset;
+        return true;
+    }
+
+    position = static_cast<uint64_t>(below - 1) * header.interval;
+    data.clear();
+    data.seekg(static_cast<std::streamoff>(entries[below - 1].offset));
+    seeks++;
+
+    // A lo sumo interval registros: la entrada siguiente ya es >= key
+    while (position < header.count) {
+        std::streampos at = data.tellg();
+        int value;
+        if (!(data >> value)) {
+            std::cerr << "Error: No se pudo leer el registro " << position << std::endl;
+            return false;
+        }
+        if (value >= key) {
+            offset = static_cast<uint64_t>(at);
+            return true;
+        }
+        position++;
+    }
+    offset = header.dataBytes;
+    return true;
+}
+
+bool SortedIndex::rank(int64_t key, uint64_t& rankOut) {
+    uint64_t offset;
+    return seekFirstNotBelow(key, rankOut, offset);
+}
+
+bool SortedIndex::range(int64_t low, int64_t high, size_t limit, uint64_t& count,
+                        std::vector<int>& values) {
+    count = 0;
+    values.clear();
+    if (low > high || header.count == 0) {
+        return true;
+    }
+
+    uint64_t first;
+    uint64_t firstOffset;
+    uint64_t end = header.count;
+    uint64_t endOffset;
+    if (!seekFirstNotBelow(low, first, firstOffset)) {
+        return false;
+    }
+    // Fuera del rango de int no hay registros: así high + 1 no desborda
+    if (high < std::numeric_limits<int>::max() &&
+        !seekFirstNotBelow(high + 1, end, endOffset)) {
+        return false;
+    }
+    count = end > first ? end - first : 0;
+
+    size_t wanted = count < limit ? static_cast<size_t>(count) : limit;
+    if (wanted == 0) {
+        return true;
+    }
+    data.clear();
+    data.seekg(static_cast<std::streamoff>(firstOffset));
+    seeks++;
+    int value;
+    while (values.size() < wanted && data >> value) {
+        values.push_back(value);
+    }
+    return values.size() == wanted;
+}
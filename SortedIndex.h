@@ -0,0 +1,206 @@
+/**
+ * @file SortedIndex.h
+ * @brief Índice disperso del archivo final ordenado (output.sorted.txt.idx)
+ * @details MergeSort anota, mientras escribe la salida de texto, la clave y el
+ *          desplazamiento en bytes de un registro cada N, más estadísticas de resumen.
+ *          Con el índice en memoria una búsqueda es binaria sobre las entradas, luego un
+ *          seek al archivo y la lectura de a lo sumo N registros.
+ *
+ * Formato: SortedIndexHeader seguido de header.entries SortedIndexEntry; la entrada i
+ * corresponde al registro i * header.interval.
+ */
+
+#ifndef SORTEDINDEX_H
+#define SORTEDINDEX_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct SortedIndexHeader
+ * @brief Encabezado de 72 bytes del índice, con el resumen de la salida
+ * @details Los campos se escriben en el orden de bytes del host, como ChunkHeader
+ */
+struct SortedIndexHeader {
+    char magic[4];          ///< Firma "ESIX"
+    uint16_t version;       ///< Versión del formato (SORTED_INDEX_VERSION)
+    uint16_t recordWidth;   ///< sizeof del registro indexado (4 para int)
+    uint32_t interval;      ///< Registros entre entradas
+    uint32_t reserved;      ///< Sin uso (cero)
+    uint64_t count;         ///< Registros de la salida
+    uint64_t distinct;      ///< Claves distintas
+    int64_t minKey;         ///< Clave mínima
+    int64_t maxKey;         ///< Clave máxima
+    double mean;            ///< Promedio de las claves
+    uint64_t dataBytes;     ///< Tamaño de la salida (detecta un índice desactualizado)
+    uint64_t entries;       ///< Entradas que siguen al encabezado
+};
+
+/**
+ * @struct SortedIndexEntry
+ * @brief Clave y posición de un registro muestreado
+ */
+struct SortedIndexEntry {
+    int64_t key;            ///< Clave del registro
+    uint64_t offset;        ///< Byte donde empieza su línea en la salida
+};
+
+static const char SORTED_INDEX_MAGIC[4] = {'E', 'S', 'I', 'X'}; ///< Firma del índice
+static const uint16_t SORTED_INDEX_VERSION = 1;                 ///< Versión actual
+static const char SORTED_INDEX_SUFFIX[] = ".idx";               ///< Sufijo del archivo lateral
+
+/**
+ * @class SortedIndexWriter
+ * @brief Acumula las entradas y el resumen mientras se escribe la salida
+ * @details Las entradas quedan en memoria hasta write(): 16 bytes cada interval
+ *          registros (4 MiB por cada mil millones de registros con el intervalo por
+ *          defecto)
+ */
+class SortedIndexWriter {
+private:
+    uint32_t interval;                      ///< Registros entre entradas (0 = desactivado)
+    uint16_t recordWidth;                   ///< sizeof del registro indexado
+    std::vector<SortedIndexEntry> entries;  ///< Entradas muestreadas
+    uint64_t count;                         ///< Registros anotados
+    uint64_t distinct;                      ///< Claves distintas anotadas
+    int64_t minKey;                         ///< Primera clave
+    int64_t lastKey;                        ///< Última clave (máxima)
+    double sum;                             ///< Suma de las claves (para el promedio)
+
+    SortedIndexWriter(const SortedIndexWriter&);            ///< No copiable
+    SortedIndexWriter& operator=(const SortedIndexWriter&); ///< No asignable
+
+public:
+    static const uint32_t DEFAULT_INTERVAL = 4096; ///< Registros entre entradas por defecto
+
+    /**
+     * @brief Constructor de un índice desactivado
+     */
+    SortedIndexWriter();
+
+    /**
+     * @brief Activa el índice y descarta lo anotado
+     * @param everyRecords Registros entre entradas (0 = desactivado)
+     * @param width sizeof del registro indexado
+     */
+    void reset(uint32_t everyRecords, uint16_t width);
+
+    /**
+     * @brief Indica si el índice está activo
+     * @return true si reset() recibió un intervalo mayor a cero
+     */
+    bool isEnabled() const {
+        return interval > 0;
+    }
+
+    /**
+     * @brief Anota un registro de la salida, en orden
+     * @param key Clave del registro
+     * @param offset Byte donde empieza el registro en la salida
+     */
+    void add(int64_t key, uint64_t offset) {
+        if (count % interval == 0) {
+            SortedIndexEntry entry;
+            entry.key = key;
+            entry.offset = offset;
+            entries.push_back(entry);
+        }
+        if (count == 0) {
+            minKey = key;
+            distinct = 1;
+        } else if (key != lastKey) {
+            distinct++;
+        }
+        lastKey = key;
+        sum += static_cast<double>(key);
+        count++;
+    }
+
+    /**
+     * @brief Escribe el índice
+     * @param filename Archivo del índice (ej: "output.sorted.txt.idx")
+     * @param dataBytes Tamaño final de la salida indexada
+     * @return false si no se pudo escribir
+     */
+    bool write(const std::string& filename, uint64_t dataBytes) const;
+};
+
+/**
+ * @class SortedIndex
+ * @brief Búsquedas sobre la salida de texto de enteros usando su índice
+ * @details Cada consulta hace una búsqueda binaria en memoria sobre las entradas, un
+ *          seek a la salida y lee a lo sumo interval registros (range además lee los
+ *          valores que devuelve)
+ */
+class SortedIndex {
+private:
+    SortedIndexHeader header;               ///< Encabezado leído
+    std::vector<SortedIndexEntry> entries;  ///< Entradas leídas
+    std::ifstream data;                     ///< Salida ordenada
+    uint64_t seeks;                         ///< Seeks hechos a la salida
+
+    SortedIndex(const SortedIndex&);            ///< No copiable
+    SortedIndex& operator=(const SortedIndex&); ///< No asignable
+
+    /**
+     * @brief Busca el primer registro con clave >= key
+     * @param key Clave buscada
+     * @param position Número del registro encontrado (header.count si no hay)
+     * @param offset Byte donde empieza ese registro
+     * @return false si la lectura de la salida falló
+     */
+    bool seekFirstNotBelow(int64_t key, uint64_t& position, uint64_t& offset);
+
+public:
+    /**
+     * @brief Constructor de un índice sin abrir
+     */
+    SortedIndex();
+
+    /**
+     * @brief Abre la salida y carga su índice
+     * @param dataFile Salida ordenada (texto, un entero por línea)
+     * @param indexFile Índice (vacío = dataFile + ".idx")
+     * @return false si falta alguno, el índice está dañado o no corresponde a la salida
+     */
+    bool open(const std::string& dataFile, const std::string& indexFile = "");
+
+    /**
+     * @brief Obtiene el encabezado con el resumen de la salida
+     * @return Encabezado del índice
+     */
+    const SortedIndexHeader& getHeader() const {
+        return header;
+    }
+
+    /**
+     * @brief Cuenta los registros menores que una clave
+     * @param key Clave de corte
+     * @param rankOut Registros < key
+     * @return false si la lectura de la salida falló
+     */
+    bool rank(int64_t key, uint64_t& rankOut);
+
+    /**
+     * @brief Busca registros en [low, high]
+     * @param low Límite inferior
+     * @param high Límite superior
+     * @param limit Valores máximos a devolver en values
+     * @param count Registros del rango
+     * @param values Los primeros limit valores del rango, en orden
+     * @return false si la lectura de la salida falló
+     */
+    bool range(int64_t low, int64_t high, size_t limit, uint64_t& count, std::vector<int>& values);
+
+    /**
+     * @brief Obtiene los seeks hechos a la salida desde open()
+     * @return Seeks realizados
+     */
+    uint64_t getSeeks() const {
+        return seeks;
+    }
+};
+
+#endif
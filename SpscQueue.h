@@ -0,0 +1,145 @@
+/**
+ * @file SpscQueue.h
+ * @brief Cola circular sin bloqueos para un productor y un consumidor
+ * @details Usada para pasar buffers entre el hilo de adquisición y el hilo que ordena
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+/**
+ * @brief Espera breve y creciente para los bucles de sondeo de las colas
+ * @param spins Intentos fallidos consecutivos (el llamador lo pone en 0 al avanzar)
+ * @details Cede el procesador las primeras veces y después duerme 200 us, para que una
+ *          espera larga no ocupe un núcleo
+ */
+inline void backoff(int& spins) {
+    if (++spins < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+/**
+ * @class SpscQueue
+ * @brief Cola acotada lock-free de un solo productor y un solo consumidor
+ * @tparam T Tipo de los elementos (copiable)
+ * @details El productor solo escribe tail y el consumidor solo escribe head; cada lado
+ *          publica sus cambios con release y lee los del otro con acquire. La capacidad
+ *          se redondea a potencia de dos para indexar con una máscara.
+ */
+template <typename T>
+class SpscQueue {
+private:
+    T* slots;                      ///< Arreglo circular de elementos
+    size_t mask;                   ///< capacidad - 1 (capacidad potencia de dos)
+    char padHead[64];              ///< Separa head de los campos de solo lectura (false sharing)
+    std::atomic<size_t> head;      ///< Siguiente posición a leer (consumidor)
+    char padTail[64];              ///< Separa head y tail en líneas de caché distintas
+    std::atomic<size_t> tail;      ///< Siguiente posición a escribir (productor)
+
+    SpscQueue(const SpscQueue&);            ///< No copiable
+    SpscQueue& operator=(const SpscQueue&); ///< No asignable
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Número mínimo de elementos que debe poder contener la cola
+     */
+    explicit SpscQueue(size_t capacity) : slots(nullptr), mask(0), head(0), tail(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots = new T[size];
+        mask = size - 1;
+    }
+
+    /**
+     * @brief Intenta encolar un elemento (solo el productor)
+     * @param value Elemento a encolar
+     * @return false si la cola está llena
+     */
+    bool tryPush(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Intenta desencolar un elemento (solo el consumidor)
+     * @param value Destino del elemento desencolado
+     * @return false si la cola está vacía
+     */
+    bool tryPop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Encola todos los elementos que quepan (solo el productor)
+     * @param values Elementos a encolar
+     * @param count Número de elementos
+     * @return Elementos encolados (puede ser menor que count si la cola se llena)
+     * @details Una sola publicación de tail para todo el lote
+     */
+    size_t tryPushBatch(const T* values, size_t count) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t space = mask + 1 - (t - head.load(std::memory_order_acquire));
+        size_t n = count < space ? count : space;
+        for (size_t i = 0; i < n; i++) {
+            slots[(t + i) & mask] = values[i];
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Desencola hasta max elementos (solo el consumidor)
+     * @param out Destino de los elementos
+     * @param max Capacidad de out
+     * @return Elementos desencolados (0 si la cola está vacía)
+     */
+    size_t tryPopBatch(T* out, size_t max) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t available = tail.load(std::memory_order_acquire) - h;
+        size_t n = max < available ? max : available;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = slots[(h + i) & mask];
+        }
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Indica si la cola está vacía (aproximado si el otro hilo está activo)
+     * @return true si no hay elementos
+     */
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Destructor que libera el arreglo de elementos
+     */
+    ~SpscQueue() {
+        delete[] slots;
+    }
+};
+
+#endif
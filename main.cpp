@@ -6,19 +6,34 @@
 
 #include "DataSource.h"
 #include "SerialSource.h"
+#include "MultiSerialSource.h"
 #include "FileSource.h"
 #include "CircularBuffer.h"
+#include "ChunkPipeline.h"
+#include "ChunkManifest.h"
+#include "LiveQuery.h"
+#include "ReplacementSelection.h"
 #include "MergeSort.h"
+#include "MergePlanner.h"
+#include "ChunkFile.h"
+#include "RunMetrics.h"
+#include "Logger.h"
+#include "ProgressReporter.h"
 #include <iostream>
 #include <fstream>
+#include <set>
+#include <sstream>
 #include <vector>
 #include <string>
 #include <thread>
 #include <atomic>
+#include <csignal>
+#include <cstdlib>
 
 #ifdef _WIN32
     #include <windows.h>
     #include <conio.h>
+    #include <io.h>
 #else
     #include <dirent.h>
     #include <cstring>
@@ -31,6 +46,236 @@ using namespace std;
 // Variable global atómica para detener el programa
 atomic<bool> stopRequested(false);
 
+// La Fase 1 se detuvo por un error de escritura o de la fuente, no por Q ni por una señal
+atomic<bool> captureFailed(false);
+
+/**
+ * @enum RunStrategy
+ * @brief Estrategia de generación de corridas de la Fase 1
+ */
+enum class RunStrategy {
+    FILL_AND_SORT,          ///< Llenar el buffer, ordenarlo y volcarlo (corridas de bufferSize)
+    REPLACEMENT_SELECTION   ///< Heap de selección por reemplazo (corridas más largas)
+};
+
+/**
+ * @struct EsortOptions
+ * @brief Parámetros de la línea de comandos
+ * @details Sin --port se pregunta el puerto por la entrada estándar; sin --mem se
+ *          conserva el buffer de 4 datos de la demostración
+ */
+struct EsortOptions {
+    vector<string> ports;             ///< Puertos a leer ("all" = todos los detectados)
+    int baudRate = 0;                 ///< Velocidad (0 = 9600 en texto, 115200 en COBS)
+    SerialProtocol protocol = SerialProtocol::TEXT; ///< Protocolo del sketch
+    string output = "output.sorted.txt"; ///< Archivo final ordenado
+    string tempDir = ".";             ///< Directorio de chunks, temporales y manifiesto
+    size_t memoryBudget = 0;          ///< Bytes para ordenar (0 = sin presupuesto)
+    ChunkFormat chunkFormat = ChunkFormat::BINARY; ///< TEXT para depurar, DELTA comprime
+    bool resume = false;              ///< Continuar el trabajo del manifiesto
+    bool allowMissing = false;        ///< Con resume, seguir sin los chunks inválidos
+    string querySocket;               ///< Socket de consultas en vivo (vacío = desactivado)
+    uint32_t indexInterval = SortedIndexWriter::DEFAULT_INTERVAL; ///< Índice de la salida (0 = sin índice)
+    bool aggregate = false;           ///< Chunks y salida como pares (valor, repeticiones)
+    bool expand = false;              ///< Con aggregate, salida con una línea por repetición
+    LogLevel logLevel = LogLevel::INFO; ///< Mensajes que se escriben en la consola
+    string metrics;                   ///< Prefijo de las métricas (vacío = junto a output)
+    RunStrategy strategy = RunStrategy::FILL_AND_SORT; ///< Generación de corridas de la Fase 1
+};
+
+/**
+ * @brief Muestra la forma de uso del programa
+ * @param program Nombre del ejecutable
+ */
+void printUsage(const char* program) {
+    cerr << "Uso: " << program << " [--port RUTA[,RUTA...]|all] [--baud N] [--protocol text|cobs]\n"
+         << "       [--output ARCHIVO] [--tmpdir DIR] [--mem TAMAÑO] [--format text|binary|delta]\n"
+         << "       [--resume [--allow-missing]] [--query-socket RUTA] [--index-interval N]\n"
+         << "       [--aggregate [--expand]] [--log-level error|warn|info|debug|trace]\n"
+         << "       [--metrics PREFIJO] [--strategy fill|replacement]\n"
+         << "  --port    Puerto(s) a leer sin preguntar (repetible; all = todos los detectados)\n"
+         << "  --mem     Memoria para ordenar, ej: 512M, 2G (define el tamaño de corrida y el fan-in)\n"
+         << "  --tmpdir  Directorio de los chunks, temporales y esort.manifest\n"
+         << "  --resume  Continúa el trabajo registrado en el manifiesto de chunks\n"
+         << "  --allow-missing  Con --resume, continúa sin los chunks faltantes o dañados\n"
+         << "  --query-socket  Responde min/max/median/rank/range durante la captura (socket UNIX)\n"
+         << "  --index-interval  Registros entre entradas del índice de la salida (0 = sin índice)\n"
+         << "  --aggregate  Agrupa lecturas repetidas en pares valor,repeticiones (chunks y salida)\n"
+         << "  --expand     Con --aggregate, escribe la salida con una línea por lectura\n"
+         << "  --log-level  info: avance por segundo; debug: cada chunk; trace: cada lectura\n"
+         << "  --metrics    Escribe PREFIJO.json y PREFIJO.prom (por defecto esort.metrics.*\n"
+         << "               en el directorio de --output)\n"
+         << "  --strategy   fill: buffers ordenados en paralelo; replacement: selección por\n"
+         << "               reemplazo (corridas ~2x más largas, un solo hilo)\n";
+}
+
+/**
+ * @brief Interpreta un tamaño en bytes con sufijo opcional K, M o G (base 1024)
+ * @param text Texto a interpretar (ej: "2G", "512M", "65536")
+ * @param bytes Tamaño resultante
+ * @return false si el texto no es un tamaño válido
+ */
+bool parseSize(const string& text, size_t& bytes) {
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (end == text.c_str() || value <= 0) {
+        return false;
+    }
+
+    string suffix(end);
+    if (!suffix.empty() && (suffix.back() == 'B' || suffix.back() == 'b')) {
+        suffix.pop_back();
+    }
+    double scale = 1;
+    if (suffix == "K" || suffix == "k") scale = 1024.0;
+    else if (suffix == "M" || suffix == "m") scale = 1024.0 * 1024.0;
+    else if (suffix == "G" || suffix == "g") scale = 1024.0 * 1024.0 * 1024.0;
+    else if (!suffix.empty()) return false;
+
+    bytes = static_cast<size_t>(value * scale);
+    return bytes > 0;
+}
+
+/**
+ * @brief Interpreta los argumentos de la línea de comandos
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @param options Opciones resultantes
+ * @return false si algún argumento es inválido o se pidió la ayuda
+ */
+bool parseOptions(int argc, char** argv, EsortOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (arg == "--resume") {
+            options.resume = true;
+            continue;
+        }
+        if (arg == "--allow-missing") {
+            options.allowMissing = true;
+            continue;
+        }
+        if (arg == "--aggregate") {
+            options.aggregate = true;
+            continue;
+        }
+        if (arg == "--expand") {
+            options.expand = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Error: Falta el valor de " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+
+        if (arg == "--port" || arg == "--ports") {
+            // Lista separada por comas o la opción repetida
+            size_t start = 0;
+            while (start <= value.size()) {
+                size_t comma = value.find(',', start);
+                if (comma == string::npos) comma = value.size();
+                if (comma > start) options.ports.push_back(value.substr(start, comma - start));
+                start = comma + 1;
+            }
+        } else if (arg == "--baud") {
+            options.baudRate = atoi(value.c_str());
+            if (options.baudRate <= 0) {
+                cerr << "Error: Velocidad inválida " << value << endl;
+                return false;
+            }
+        } else if (arg == "--protocol") {
+            if (value != "text" && value != "cobs") return false;
+            options.protocol = value == "cobs" ? SerialProtocol::COBS : SerialProtocol::TEXT;
+        } else if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--index-interval") {
+            char* end = nullptr;
+            long interval = strtol(value.c_str(), &end, 10);
+            if (end == value.c_str() || *end != '\0' || interval < 0 || interval > 0x7FFFFFFFL) {
+                cerr << "Error: Intervalo de índice inválido " << value << endl;
+                return false;
+            }
+            options.indexInterval = static_cast<uint32_t>(interval);
+        } else if (arg == "--log-level") {
+            if (!Logger::parseLevel(value, options.logLevel)) {
+                cerr << "Error: Nivel de registro inválido " << value << endl;
+                return false;
+            }
+        } else if (arg == "--strategy") {
+            if (value == "fill") options.strategy = RunStrategy::FILL_AND_SORT;
+            else if (value == "replacement") options.strategy = RunStrategy::REPLACEMENT_SELECTION;
+            else return false;
+        } else if (arg == "--metrics") {
+            options.metrics = value;
+        } else if (arg == "--query-socket") {
+            options.querySocket = value;
+        } else if (arg == "--tmpdir") {
+            options.tempDir = value;
+        } else if (arg == "--mem") {
+            if (!parseSize(value, options.memoryBudget)) {
+                cerr << "Error: Tamaño de memoria inválido " << value << endl;
+                return false;
+            }
+        } else if (arg == "--format") {
+            if (value == "text") options.chunkFormat = ChunkFormat::TEXT;
+            else if (value == "binary") options.chunkFormat = ChunkFormat::BINARY;
+            else if (value == "delta") options.chunkFormat = ChunkFormat::DELTA;
+            else return false;
+        } else {
+            cerr << "Error: Opción desconocida " << arg << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Une un directorio y un nombre de archivo
+ * @param dir Directorio ("." o vacío = directorio actual)
+ * @param name Nombre del archivo
+ * @return Ruta resultante
+ */
+string joinPath(const string& dir, const string& name) {
+    if (dir.empty() || dir == ".") return name;
+    char last = dir[dir.size() - 1];
+    if (last == '/' || last == '\\') return dir + name;
+    return dir + "/" + name;
+}
+
+/**
+ * @brief Obtiene el directorio de una ruta de archivo
+ * @param path Ruta (ej: "/datos/salida.txt")
+ * @return Directorio sin la barra final ("." si la ruta no tiene directorio)
+ */
+string dirName(const string& path) {
+    size_t slash = path.find_last_of("/\\");
+    if (slash == string::npos) return ".";
+    if (slash == 0) return path.substr(0, 1);
+    return path.substr(0, slash);
+}
+
+/**
+ * @brief Manejador de SIGINT/SIGTERM: detiene el programa igual que la tecla Q
+ * @param signum Señal recibida
+ */
+void onStopSignal(int signum) {
+    (void)signum;
+    stopRequested = true;
+}
+
+/**
+ * @brief Indica si la entrada estándar es una terminal interactiva
+ * @return false si se ejecuta sin terminal (supervisor, redirección)
+ */
+bool stdinIsTerminal() {
+#ifdef _WIN32
+    return _isatty(_fileno(stdin)) != 0;
+#else
+    return isatty(STDIN_FILENO) != 0;
+#endif
+}
+
 /**
  * @brief Función que detecta la tecla Q en un hilo separado
  * @details Monitorea constantemente el teclado
@@ -41,7 +286,7 @@ void keyboardListener() {
         if (_kbhit()) {
             char key = _getch();
             if (key == 'q' || key == 'Q') {
-                cout << "\n\n[!] Tecla Q presionada. Deteniendo el programa..." << endl;
+                Logger::instance().write(LogLevel::INFO, "[!] Tecla Q presionada. Deteniendo el programa...");
                 stopRequested = true;
                 break;
             }
@@ -68,9 +313,11 @@ void keyboardListener() {
 
         if (result > 0) {
             char key;
-            read(STDIN_FILENO, &key, 1);
+            if (read(STDIN_FILENO, &key, 1) != 1) {
+                break;  // Entrada cerrada: no habrá más teclas
+            }
             if (key == 'q' || key == 'Q') {
-                cout << "\n\n[!] Tecla Q presionada. Deteniendo el programa..." << endl;
+                Logger::instance().write(LogLevel::INFO, "[!] Tecla Q presionada. Deteniendo el programa...");
                 stopRequested = true;
                 break;
             }
@@ -129,9 +376,9 @@ vector<string> detectSerialPorts() {
 /**
  * @brief Muestra los puertos disponibles y solicita selección al usuario
  * @param ports Vector de puertos detectados
- * @return Puerto seleccionado por el usuario
+ * @return Puertos seleccionados por el usuario (todos si elige 0)
  */
-string selectPort(const vector<string>& ports) {
+vector<string> selectPorts(const vector<string>& ports) {
     if (ports.empty()) {
         cerr << "Error: No se detectaron puertos seriales disponibles." << endl;
         cerr << "Verifica que el Arduino esté conectado." << endl;
@@ -144,106 +391,185 @@ string selectPort(const vector<string>& ports) {
     }
 
     int selection;
-    cout << "\nSelecciona el puerto (1-" << ports.size() << "): ";
-    cin >> selection;
+    cout << "\nSelecciona el puerto (1-" << ports.size() << ", 0 = todos): ";
+    if (!(cin >> selection)) {
+        cerr << "Error: No se pudo leer la selección; usa --port para elegir sin preguntar." << endl;
+        exit(1);
+    }
 
-    if (selection < 1 || selection > (int)ports.size()) {
+    if (selection < 0 || selection > (int)ports.size()) {
         cerr << "Error: Selección inválida." << endl;
         exit(1);
     }
 
-    return ports[selection - 1];
+    if (selection == 0) {
+        return ports;
+    }
+    return vector<string>(1, ports[selection - 1]);
 }
 
 /**
  * @brief Fase 1: Adquisición y Segmentación
  * @param source Fuente de datos (SerialSource)
  * @param bufferSize Tamaño del buffer circular
+ * @param chunkFormat Formato de los chunks generados (texto o binario)
+ * @param sortWorkers Hilos que ordenan y escriben chunks en paralelo
+ * @param chunkPrefix Prefijo (directorio incluido) de los chunks
+ * @param metrics Métricas de la ejecución (tiempos por chunk)
+ * @param manifest Manifiesto donde se registra cada chunk terminado
+ * @param startIndex Número del primer chunk (mayor a 1 al reanudar)
+ * @param live Índice de consultas en vivo (nullptr si no hay servidor de consultas)
+ * @param aggregate true para escribir los chunks como pares (valor, repeticiones)
  * @return Vector con nombres de archivos chunks generados
- * @details Lee datos del serial, los ordena en chunks y los guarda en archivos
+ * @details Lee datos del serial y entrega cada buffer lleno a un ChunkPipeline, cuyo pool
+ *          de trabajadores lo ordena y lo guarda en un archivo sin detener la lectura
  */
-vector<string> phase1_AcquisitionAndSegmentation(DataSource* source, int bufferSize) {
-    cout << "\nIniciando Fase 1: Adquisición de datos..." << endl;
-    cout << "[Presiona Q para detener en cualquier momento]" << endl;
-
-    CircularBuffer buffer(bufferSize);
-    vector<string> chunkFiles;
-    int chunkCounter = 1;
-
-    while (source->hasMoreData() && !stopRequested) {
-        int value = source->getNext();
-
-        if (stopRequested) {
-            cout << "\nDetención solicitada. Finalizando Fase 1..." << endl;
+vector<string> phase1_AcquisitionAndSegmentation(DataSource* source, int bufferSize,
+                                                 ChunkFormat chunkFormat, int sortWorkers,
+                                                 const string& chunkPrefix, RunMetrics& metrics,
+                                                 ChunkManifest* manifest,
+                                                 int startIndex, LiveIndex* live,
+                                                 bool aggregate) {
+    Logger& log = Logger::instance();
+    log.write(LogLevel::INFO, "Iniciando Fase 1: Adquisición de datos...");
+    log.write(LogLevel::INFO, "[Presiona Q para detener en cualquier momento]");
+
+    // Los trabajadores del pipeline ordenan y escriben cada buffer lleno mientras
+    // este hilo sigue leyendo del serial en el siguiente buffer libre
+    ChunkPipeline pipeline(bufferSize, chunkFormat, sortWorkers, 2, chunkPrefix, startIndex);
+    pipeline.setMetrics(&metrics);
+    pipeline.setManifest(manifest);
+    pipeline.setLiveIndex(live);
+    pipeline.setAggregate(aggregate);
+    CircularBuffer* buffer = pipeline.acquire();
+    if (live != nullptr) live->setAcquiring(true);
+
+    // Lectura por lotes: una llamada virtual por lote y un estado explícito de fin/error
+    const size_t READ_BATCH = 1024;
+    int batch[READ_BATCH];
+
+    // El avance reemplaza el mensaje por lectura; este solo queda en el nivel TRACE
+    ProgressReporter progress("Fase 1", "lecturas");
+    progress.start();
+    bool traceValues = log.enabled(LogLevel::TRACE);
+
+    // Con Q se deja de leer el dispositivo, pero lo que la fuente ya recibió (las colas
+    // de MultiSerialSource) se sigue consumiendo hasta que read() devuelve 0
+    bool draining = false;
+    while (true) {
+        if (pipeline.hasWriteFailed()) {
             break;
         }
+        if (stopRequested && !draining) {
+            if (!source->stopAcquisition()) {
+                break;
+            }
+            draining = true;
+        }
+        size_t count = source->read(batch, READ_BATCH);
+        if (count == 0) {
+            break;
+        }
+        progress.add(count);
 
-        cout << "Leyendo -> " << value << endl;
-
-        if (!buffer.insert(value)) {
-            cout << "Buffer lleno. Ordenando internamente..." << endl;
-            buffer.sort();
+        for (size_t i = 0; i < count; i++) {
+            int value = batch[i];
+            if (traceValues) log.write(LogLevel::TRACE, "Leyendo -> " + to_string(value));
 
-            string filename = "chunk_0" + to_string(chunkCounter) + ".tmp";
-            ofstream chunkFile(filename);
+            if (!buffer->insert(value)) {
+                pipeline.submit(buffer);
+                buffer = pipeline.acquire();
+                buffer->insert(value);
+            }
+        }
 
-            if (chunkFile.is_open()) {
-                int* data = new int[bufferSize];
-                buffer.getData(data, bufferSize);
+        // Entre lotes: copia del buffer solo si una consulta la está esperando
+        if (live != nullptr) live->serviceSnapshot(*buffer);
+    }
 
-                cout << "Escribiendo " << filename << "... OK." << endl;
-                cout << "Buffer ordenado: [";
-                for (int i = 0; i < buffer.size(); i++) {
-                    chunkFile << data[i] << endl;
-                    cout << data[i];
-                    if (i < buffer.size() - 1) cout << ", ";
-                }
-                cout << "]" << endl;
+    if (stopRequested && !pipeline.hasWriteFailed()) {
+        log.write(LogLevel::INFO, "Detención solicitada. Finalizando Fase 1...");
+    } else if (source->getStatus() == ReadStatus::IO_ERROR) {
+        log.write(LogLevel::ERR, "La fuente de datos falló; se conservan los datos leídos");
+    }
 
-                delete[] data;
-                chunkFile.close();
-                chunkFiles.push_back(filename);
-                chunkCounter++;
-            }
+    // El buffer parcial también se vuelca al detener con Q: sus datos ya se leyeron
+    // del serial y un --resume posterior no podría recuperarlos de otro modo
+    if (!buffer->isEmpty()) {
+        pipeline.submit(buffer);
+    }
+    if (live != nullptr) live->setAcquiring(false);
 
-            buffer.clear();
-            cout << "Buffer limpiado." << endl;
+    vector<string> chunkFiles = pipeline.finish();
+    progress.finish();
 
-            buffer.insert(value);
-        }
+    // También un fallo en los últimos buffers: sin fusión ni sello, como en
+    // phase1_ReplacementSelection
+    if (pipeline.hasWriteFailed()) {
+        log.write(LogLevel::ERR, "No se pudo escribir un chunk; se detiene la captura");
+        captureFailed = true;
+        stopRequested = true;
     }
 
-    if (!buffer.isEmpty() && !stopRequested) {
-        cout << "Buffer lleno. Ordenando internamente..." << endl;
-        buffer.sort();
+    log.write(LogLevel::INFO, "(El Arduino se detiene o se cierra la conexión)");
+    log.write(LogLevel::INFO, "Fase 1 completada. " + to_string(chunkFiles.size()) +
+                                  " chunks generados.");
 
-        string filename = "chunk_0" + to_string(chunkCounter) + ".tmp";
-        ofstream chunkFile(filename);
+    return chunkFiles;
+}
 
-        if (chunkFile.is_open()) {
-            int* data = new int[bufferSize];
-            buffer.getData(data, bufferSize);
+/**
+ * @brief Fase 1 (alternativa): Adquisición con selección por reemplazo
+ * @param source Fuente de datos (SerialSource)
+ * @param bufferSize Número de datos que caben en el heap
+ * @param chunkFormat Formato de las corridas generadas
+ * @param chunkPrefix Prefijo (directorio incluido) de las corridas
+ * @param metrics Métricas de la ejecución (tamaños de corrida)
+ * @param manifest Manifiesto donde se registra cada corrida cerrada
+ * @param startIndex Número de la primera corrida (mayor a 1 al reanudar)
+ * @return Vector con nombres de las corridas generadas
+ * @details Genera corridas de longitud variable y reporta sus longitudes al terminar
+ */
+vector<string> phase1_ReplacementSelection(DataSource* source, int bufferSize,
+                                           ChunkFormat chunkFormat, const string& chunkPrefix,
+                                           RunMetrics& metrics, ChunkManifest* manifest,
+                                           int startIndex) {
+    Logger& log = Logger::instance();
+    log.write(LogLevel::INFO, "Iniciando Fase 1: Adquisición con selección por reemplazo...");
+    log.write(LogLevel::INFO, "[Presiona Q para detener en cualquier momento]");
+
+    ProgressReporter progress("Fase 1", "lecturas");
+    ReplacementSelection generator(bufferSize, chunkFormat, chunkPrefix);
+    generator.setManifest(manifest);
+    generator.setProgress(&progress);
+    progress.start();
+    vector<string> chunkFiles = generator.generate(source, stopRequested, startIndex);
+    progress.finish();
+
+    if (generator.hasWriteFailed()) {
+        // Sin fusión ni sello: las corridas escritas quedan en el manifiesto para --resume
+        log.write(LogLevel::ERR, "No se pudo escribir una corrida; se detiene la captura");
+        captureFailed = true;
+        stopRequested = true;
+    } else if (stopRequested) {
+        log.write(LogLevel::INFO, "Detención solicitada. Finalizando Fase 1...");
+    }
 
-            cout << "Escribiendo " << filename << "... OK." << endl;
-            cout << "Buffer ordenado: [";
-            for (int i = 0; i < buffer.size(); i++) {
-                chunkFile << data[i] << endl;
-                cout << data[i];
-                if (i < buffer.size() - 1) cout << ", ";
-            }
-            cout << "]" << endl;
+    if (source->getStatus() == ReadStatus::IO_ERROR) {
+        log.write(LogLevel::ERR, "La fuente de datos falló; se conservan los datos leídos");
+    }
 
-            delete[] data;
-            chunkFile.close();
-            chunkFiles.push_back(filename);
-        }
+    // Reporte de varias líneas: directo a la consola, después de lo ya encolado
+    log.flush();
+    generator.printReport(cout);
 
-        buffer.clear();
-        cout << "Buffer limpiado." << endl;
+    // Las corridas se ordenan y escriben mientras llegan los datos: sin tiempos separados
+    const vector<uint64_t>& runLengths = generator.getRunLengths();
+    for (size_t i = 0; i < runLengths.size(); i++) {
+        metrics.recordChunk(runLengths[i], 0, 0);
     }
-
-    cout << "(El Arduino se detiene o se cierra la conexión)" << endl;
-    cout << "Fase 1 completada. " << chunkFiles.size() << " chunks generados." << endl;
+    log.write(LogLevel::INFO, "Fase 1 completada. " + to_string(chunkFiles.size()) +
+                                  " chunks generados.");
 
     return chunkFiles;
 }
@@ -252,69 +578,297 @@ vector<string> phase1_AcquisitionAndSegmentation(DataSource* source, int bufferS
  * @brief Fase 2: Fusión Externa (K-Way Merge)
  * @param chunkFiles Vector con nombres de archivos a fusionar
  * @param outputFile Nombre del archivo de salida final
- * @details Aplica K-Way Merge para fusionar todos los chunks en un archivo ordenado
+ * @param memoryBudget Bytes disponibles para la fusión (determinan el fan-in)
+ * @param tempFormat Formato de los temporales de las pasadas intermedias
+ * @param tempPrefix Prefijo (directorio incluido) de los temporales
+ * @param indexInterval Registros entre entradas del índice de la salida (0 = sin índice)
+ * @param aggregate true si los chunks son pares (valor, repeticiones)
+ * @param expand Con aggregate, escribir una línea por repetición en la salida
+ * @param metrics Métricas de la ejecución (K, pasadas, comparaciones)
+ * @param manifest Manifiesto donde se marca la fusión terminada
+ * @return true si la fusión se completó
+ * @details Aplica K-Way Merge para fusionar todos los chunks en un archivo ordenado,
+ *          en varias pasadas si hay más chunks que el fan-in permitido
  */
-void phase2_ExternalMerge(const vector<string>& chunkFiles, const string& outputFile) {
+bool phase2_ExternalMerge(const vector<string>& chunkFiles, const string& outputFile,
+                          size_t memoryBudget, ChunkFormat tempFormat,
+                          const string& tempPrefix, uint32_t indexInterval, bool aggregate,
+                          bool expand, RunMetrics& metrics, ChunkManifest& manifest) {
+    Logger& log = Logger::instance();
     if (stopRequested) {
-        cout << "\nFase 2 cancelada por el usuario." << endl;
-        return;
+        log.write(LogLevel::INFO, captureFailed ? "Fase 2 cancelada: la Fase 1 falló."
+                                                : "Fase 2 cancelada por el usuario.");
+        log.write(LogLevel::INFO, "Los chunks quedan registrados en el manifiesto; "
+                                  "ejecuta con --resume para continuar.");
+        return false;
     }
 
-    cout << endl << "Iniciando Fase 2: Fusión Externa (K-Way Merge)" << endl;
-    cout << "Abriendo " << chunkFiles.size() << " archivos fuente..." << endl;
-
-    MergeSort merger(chunkFiles, outputFile);
-
-    cout << "K=" << chunkFiles.size() << ". Fusión en progreso..." << endl;
-
-    for (size_t i = 0; i < chunkFiles.size(); i++) {
-        ifstream file(chunkFiles[i]);
-        if (file.is_open()) {
-            int first, second;
-            file >> first >> second;
-            cout << "- Min(" << chunkFiles[i] << "), " << chunkFiles[i]
-                 << "[1]) -> " << first << ". Escribiendo " << first << "." << endl;
-            cout << "- Min(" << chunkFiles[i] << "[1], " << chunkFiles[i]
-                 << "[2]) -> " << second << ". Escribiendo " << second << "." << endl;
-            file.close();
-        }
+    log.write(LogLevel::INFO, "Iniciando Fase 2: Fusión Externa (K-Way Merge)");
+
+    MergePlanner planner(MergePlanner::chooseFanIn(memoryBudget), tempPrefix,
+                         BlockWriter::DEFAULT_BLOCK_SIZE, tempFormat);
+    planner.setOutputIndex(indexInterval);
+    planner.setExpandOutput(expand);
+
+    ostringstream summary;
+    summary << "K=" << chunkFiles.size() << ", fan-in máximo=" << planner.getFanIn()
+            << ". Fusión en progreso...";
+    log.write(LogLevel::INFO, summary.str());
+
+    // Trabajo esperado para el ETA: los registros de cada chunk salen del manifiesto (sin
+    // abrir los archivos) y cada pasada los lee a lo sumo una vez
+    set<string> inputs(chunkFiles.begin(), chunkFiles.end());
+    vector<ManifestEntry> entries = manifest.getEntries();
+    uint64_t inputRecords = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (inputs.count(entries[i].filename) > 0) inputRecords += entries[i].records;
     }
+    ProgressReporter progress("Fase 2", "registros");
+    planner.setProgress(&progress);
+    progress.start(inputRecords * planner.countPasses(chunkFiles.size()));
+
+    metrics.beginPhase(2);
+    // Con --aggregate el torneo suma las repeticiones de un valor entre chunks
+    bool merged = aggregate ? planner.run<CountedValue, CountedValueKey>(chunkFiles, outputFile)
+                            : planner.run(chunkFiles, outputFile);
+    metrics.endPhase(2);
+    progress.finish();
+    metrics.recordMerge(planner.getFanIn(), planner.getPassCount(), chunkFiles.size(),
+                        planner.getRecordsMerged(), planner.getOutputRecords(),
+                        planner.getComparisons());
+
+    if (!merged) {
+        log.write(LogLevel::ERR, "La fusión no se completó; los chunks se conservan para --resume");
+        return false;
+    }
+    manifest.markMerged(outputFile, planner.getOutputRecords());
 
-    merger.merge();
-
-    cout << "... (etc.)" << endl;
-    cout << endl << "Fusión completada. Archivo final: " << outputFile << endl;
-    cout << "Liberando memoria... Sistema apagado." << endl;
+    log.write(LogLevel::INFO, "Pasadas de fusión: " + to_string(planner.getPassCount()));
+    log.write(LogLevel::INFO, "Fusión completada. Archivo final: " + outputFile);
+    if (indexInterval > 0) {
+        log.write(LogLevel::INFO, "Índice: " + outputFile + SORTED_INDEX_SUFFIX + " (esort_lookup)");
+    }
+    log.write(LogLevel::INFO, "Liberando memoria... Sistema apagado.");
+    return true;
 }
 
 /**
  * @brief Función principal
+ * @param argc Número de argumentos
+ * @param argv Argumentos (ver printUsage)
  * @return Código de salida del programa
  * @details Coordina las dos fases del sistema E-Sort
  */
-int main() {
+int main(int argc, char** argv) {
+    EsortOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Las fases registran a través de un hilo escritor: la consola no frena la lectura
+    Logger& log = Logger::instance();
+    log.setLevel(options.logLevel);
+    log.start();
+
     cout << "Caso de Estudio: Sistema de Ordenamiento Externo para Telemetría Masiva (E-Sort)" << endl;
-    cout << "Detectando puertos seriales..." << endl;
 
-    const int BUFFER_SIZE = 4;
-    const string OUTPUT_FILE = "output.sorted.txt";
+    const int DEMO_BUFFER_SIZE = 4;                        // Buffer sin --mem (demostración)
+    const size_t DEFAULT_MERGE_MEMORY = 64 * 1024 * 1024;  // Fase 2 sin --mem
+    const RunStrategy RUN_STRATEGY = options.strategy;
+    const int BAUD_RATE = options.baudRate > 0 ? options.baudRate
+                        : (options.protocol == SerialProtocol::COBS ? 115200 : 9600);
+    const int SORT_WORKERS = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+    const string METRICS_PREFIX = options.metrics.empty()
+                                ? joinPath(dirName(options.output), "esort.metrics")
+                                : options.metrics;
+    const string METRICS_JSON = METRICS_PREFIX + ".json";  // Métricas al terminar
+    const string METRICS_PROM = METRICS_PREFIX + ".prom";  // Métricas periódicas (Prometheus)
+    const int METRICS_INTERVAL_MS = 1000;
+    const string MANIFEST_FILE = joinPath(options.tempDir, "esort.manifest"); // Para --resume
+    const string CHUNK_PREFIX = joinPath(options.tempDir, "chunk_0");
+    const string MERGE_PREFIX = joinPath(options.tempDir, "merge");
+
+    // Las dos fases no se solapan: cada una puede usar el presupuesto completo
+    int bufferSize = DEMO_BUFFER_SIZE;
+    size_t mergeMemory = DEFAULT_MERGE_MEMORY;
+    if (options.memoryBudget > 0) {
+        bufferSize = RUN_STRATEGY == RunStrategy::REPLACEMENT_SELECTION
+                         ? ReplacementSelection::chooseCapacity(options.memoryBudget)
+                         : ChunkPipeline::chooseBufferSize(options.memoryBudget, SORT_WORKERS, 2,
+                                                           options.aggregate);
+        mergeMemory = options.memoryBudget;
+        cout << "Memoria: " << options.memoryBudget / (1024 * 1024) << " MiB -> corridas de "
+             << bufferSize << " datos, fan-in " << MergePlanner::chooseFanIn(mergeMemory) << endl;
+    }
+
+    if (options.aggregate && RUN_STRATEGY == RunStrategy::REPLACEMENT_SELECTION) {
+        cerr << "Error: --aggregate requiere la estrategia de llenar y ordenar" << endl;
+        return 1;
+    }
+    if (options.expand && !options.aggregate) {
+        cerr << "Advertencia: --expand solo tiene efecto con --aggregate" << endl;
+    }
+    if (options.allowMissing && !options.resume) {
+        cerr << "Advertencia: --allow-missing solo tiene efecto con --resume" << endl;
+    }
+    if (options.aggregate && !options.querySocket.empty()) {
+        cerr << "Advertencia: Las consultas en vivo no están disponibles con --aggregate" << endl;
+        options.querySocket.clear();
+    }
+    if (RUN_STRATEGY == RunStrategy::REPLACEMENT_SELECTION && !options.querySocket.empty()) {
+        cerr << "Advertencia: Las consultas en vivo solo están disponibles con --strategy fill"
+             << endl;
+        options.querySocket.clear();
+    }
+
+    // Manifiesto: un trabajo nuevo lo trunca; --resume valida y reutiliza sus chunks
+    ChunkManifest manifest(MANIFEST_FILE);
+    vector<string> chunkFiles;
+    int startIndex = 1;
+
+    if (options.resume) {
+        if (!manifest.load()) {
+            return 1;
+        }
+        if (manifest.isMerged()) {
+            cout << "El trabajo ya terminó. Archivo final: " << manifest.getMergedOutput() << endl;
+            return 0;
+        }
+        // Chunks de otro formato o de pares no se pueden fusionar con los nuevos
+        if (manifest.getChunkFormat() != options.chunkFormat ||
+            manifest.isAggregated() != options.aggregate) {
+            cerr << "Error: El trabajo se inició con --format "
+                 << chunkFormatName(manifest.getChunkFormat())
+                 << (manifest.isAggregated() ? " --aggregate" : " sin --aggregate")
+                 << "; usa las mismas opciones con --resume" << endl;
+            return 1;
+        }
+        uint64_t validRecords = 0;
+        bool allValid = manifest.validate(chunkFiles, validRecords);
+        if (!allValid && !options.allowMissing) {
+            // Fusionar lo que queda perdería datos en silencio
+            cerr << "Error: Hay chunks faltantes o dañados; no se reanuda. Usa --allow-missing "
+                 << "para continuar sin ellos." << endl;
+            return 1;
+        }
+        startIndex = manifest.nextIndex();
+        cout << "Reanudando: " << chunkFiles.size() << " de " << manifest.getEntries().size()
+             << " chunks válidos (" << validRecords << " registros)." << endl;
+    } else if (!manifest.create(options.chunkFormat, options.aggregate)) {
+        return 1;
+    }
+
+    // Un manifiesto sellado ya tiene la Fase 1 completa: se pasa directo a la fusión
+    vector<string> selectedPorts;
+    if (!manifest.isSealed()) {
+        vector<string> availablePorts;
+        bool allPorts = options.ports.empty();
+        for (size_t i = 0; i < options.ports.size(); i++) {
+            if (options.ports[i] == "all") allPorts = true;
+        }
+        if (allPorts) {
+            cout << "Detectando puertos seriales..." << endl;
+            availablePorts = detectSerialPorts();
+        }
 
-    // Detectar puertos disponibles
-    vector<string> availablePorts = detectSerialPorts();
+        if (options.ports.empty()) {
+            // Sin --port: selección interactiva
+            selectedPorts = selectPorts(availablePorts);
+        } else if (allPorts) {
+            if (availablePorts.empty()) {
+                cerr << "Error: No se detectaron puertos seriales disponibles." << endl;
+                return 1;
+            }
+            selectedPorts = availablePorts;
+        } else {
+            selectedPorts = options.ports;
+        }
+    }
+
+    // Consultas en vivo: los chunks reutilizados por --resume también se consultan
+    LiveIndex liveIndex;
+    QueryServer queryServer(liveIndex, options.querySocket);
+    bool liveQueries = false;
+    if (!options.querySocket.empty() && !selectedPorts.empty()) {
+        for (size_t i = 0; i < chunkFiles.size(); i++) {
+            liveIndex.addChunkFile(chunkFiles[i]);
+        }
+        liveQueries = queryServer.start();
+        if (liveQueries) {
+            cout << "Consultas en vivo en " << options.querySocket << endl;
+        }
+    }
+
+    // SIGINT/SIGTERM detienen igual que Q (útil bajo un supervisor, sin terminal)
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
 
-    // Seleccionar puerto
-    string selectedPort = selectPort(availablePorts);
+    // Iniciar hilo para detectar la tecla Q (solo con una terminal interactiva)
+    if (stdinIsTerminal()) {
+        thread keyListener(keyboardListener);
+        keyListener.detach();
+    }
+
+    // Métricas: el archivo Prometheus se reescribe cada segundo mientras dura la ejecución
+    RunMetrics metrics;
+    metrics.startExport(METRICS_PROM, METRICS_INTERVAL_MS);
+
+    if (selectedPorts.empty()) {
+        cout << "Fase 1 ya completada; se omite la adquisición." << endl;
+    } else {
+        // Con varios puertos, un lector por puerto alimenta el mismo generador de corridas
+        DataSource* source = nullptr;
+        if (selectedPorts.size() == 1) {
+            cout << "\nConectando a " << selectedPorts[0] << " (Arduino)... ";
+            source = new SerialSource(selectedPorts[0], BAUD_RATE, 2000, options.protocol);
+        } else {
+            cout << "\nConectando a " << selectedPorts.size() << " puertos (Arduino)..." << endl;
+            source = new MultiSerialSource(selectedPorts, BAUD_RATE, 2000, options.protocol);
+        }
 
-    cout << "\nConectando a " << selectedPort << " (Arduino)... ";
-    SerialSource serial(selectedPort, 9600);
+        metrics.attachSource(source);
+        metrics.beginPhase(1);
+
+        vector<string> newChunks;
+        if (RUN_STRATEGY == RunStrategy::REPLACEMENT_SELECTION) {
+            newChunks = phase1_ReplacementSelection(source, bufferSize, options.chunkFormat,
+                                                    CHUNK_PREFIX, metrics, &manifest, startIndex);
+        } else {
+            newChunks = phase1_AcquisitionAndSegmentation(source, bufferSize, options.chunkFormat,
+                                                          SORT_WORKERS, CHUNK_PREFIX, metrics,
+                                                          &manifest, startIndex,
+                                                          liveQueries ? &liveIndex : nullptr,
+                                                          options.aggregate);
+        }
+        chunkFiles.insert(chunkFiles.end(), newChunks.begin(), newChunks.end());
+        metrics.endPhase(1);
+        metrics.detachSource();
+
+        // Solo una fuente agotada cierra la Fase 1; con Q o error se puede seguir capturando.
+        // Con error tampoco se fusiona: la fusión marcaría el trabajo como terminado
+        if (source->getStatus() == ReadStatus::IO_ERROR) {
+            captureFailed = true;
+            stopRequested = true;
+        } else if (!stopRequested) {
+            manifest.seal();
+        }
+        delete source;
+    }
 
-    // Iniciar hilo para detectar la tecla Q
-    thread keyListener(keyboardListener);
-    keyListener.detach();
+    // La fusión borra los temporales intermedios: las consultas terminan con la Fase 1
+    queryServer.stop();
 
-    vector<string> chunkFiles = phase1_AcquisitionAndSegmentation(&serial, BUFFER_SIZE);
+    bool merged = phase2_ExternalMerge(chunkFiles, options.output, mergeMemory,
+                                       options.chunkFormat, MERGE_PREFIX, options.indexInterval,
+                                       options.aggregate, options.expand, metrics, manifest);
 
-    phase2_ExternalMerge(chunkFiles, OUTPUT_FILE);
+    metrics.stopExport();
+    if (metrics.writeJsonFile(METRICS_JSON)) {
+        log.write(LogLevel::INFO, "Métricas: " + METRICS_JSON + " y " + METRICS_PROM);
+    }
 
-    return 0;
-}
\ No newline at end of file
+    log.stop();
+    // Detenerse con Q o una señal no es un fallo: los chunks quedan para --resume
+    return merged || (stopRequested && !captureFailed) ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+// Envía lecturas en tramas binarias COBS con CRC-16 (SerialProtocol::COBS).
+// Trama antes de COBS: [n][n lecturas int32 little-endian][CRC-16/CCITT little-endian]
+// Tras COBS la trama no contiene 0x00 y se termina con un 0x00.
+
+const int READINGS_PER_FRAME = 8;
+
+uint16_t crc16(const uint8_t* data, size_t size) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+size_t cobsEncode(const uint8_t* input, size_t size, uint8_t* output) {
+  size_t codePos = 0;
+  size_t out = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < size; i++) {
+    if (input[i] == 0) {
+      output[codePos] = code;
+      codePos = out++;
+      code = 1;
+    } else {
+      output[out++] = input[i];
+      code++;
+      if (code == 0xFF) {
+        output[codePos] = code;
+        codePos = out++;
+        code = 1;
+      }
+    }
+  }
+  output[codePos] = code;
+  return out;
+}
+
+void sendFrame(const long* readings, int count) {
+  uint8_t payload[1 + 4 * READINGS_PER_FRAME + 2];
+  uint8_t encoded[sizeof(payload) + 2];
+  size_t size = 0;
+
+  payload[size++] = count;
+  for (int i = 0; i < count; i++) {
+    uint32_t v = (uint32_t)readings[i];
+    payload[size++] = v;
+    payload[size++] = v >> 8;
+    payload[size++] = v >> 16;
+    payload[size++] = v >> 24;
+  }
+  uint16_t crc = crc16(payload, size);
+  payload[size++] = crc;
+  payload[size++] = crc >> 8;
+
+  size_t n = cobsEncode(payload, size, encoded);
+  encoded[n++] = 0;
+  Serial.write(encoded, n);
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  long readings[] = {105, 5, 210, 99, 1, 500, 20, 15};
+  int numReadings = 8;
+
+  for (int start = 0; start < numReadings; start += READINGS_PER_FRAME) {
+    int count = numReadings - start < READINGS_PER_FRAME ? numReadings - start : READINGS_PER_FRAME;
+    sendFrame(readings + start, count);
+    delay(100);
+  }
+}
+
+void loop() {
+}